@@ -0,0 +1,173 @@
+#include <cmath>
+#include <algorithm>
+
+#include "ArrivalGenerator.h"
+#include "ConsoleManager.h"
+#include "Process.h"
+#include "Random.h"
+
+static const double PI = 3.14159265358979323846;
+
+bool ArrivalGenerator::isKnownModel(const std::string& model) {
+	return model == "batch" || model == "poisson" || model == "on-off" || model == "diurnal" || model == "closed-loop";
+}
+
+bool ArrivalGenerator::isKnownDistribution(const std::string& distribution) {
+	return distribution == "uniform" || distribution == "lognormal" || distribution == "bimodal";
+}
+
+void ArrivalGenerator::start() {
+	std::lock_guard<std::mutex> lock(generatorMutex);
+	ConsoleManager* console = ConsoleManager::getInstance();
+	TimerWheel* clock = TimerWheel::getInstance();
+
+	model = console->getArrivalModel();
+	rate = console->getArrivalRate() / 1000.0;
+	burstOnTicks = std::max(1, console->getBurstOnTicks());
+	burstOffTicks = std::max(0, console->getBurstOffTicks());
+	diurnalPeriod = std::max(1, console->getDiurnalPeriod());
+	thinkTicks = std::max(0, console->getThinkTicks());
+	batchTicks = std::max(1, 1000 / std::max(1, console->getTickDuration()));
+	batchSize = console->getBatchProcessFrequency();
+	nextArrival = 0;
+	running = true;
+
+	clock->schedule(arrivalTimer, 1, [this]() { begin(); });
+}
+
+// Runs on the clock thread; the first arrival is measured from the next exec tick
+void ArrivalGenerator::begin() {
+	std::lock_guard<std::mutex> lock(generatorMutex);
+	if (!running) {
+		return;
+	}
+
+	ConsoleManager* console = ConsoleManager::getInstance();
+	TimerWheel* clock = TimerWheel::getInstance();
+	uint64_t ticksPerExec = std::max(1, console->getDelayPerExec());
+	startTick = (clock->getCurrentTick() / ticksPerExec + 1) * ticksPerExec;
+
+	if (model == "closed-loop") {
+		// Start each user partway through a think so they do not all submit on the first tick
+		users.assign(std::max(0, console->getClosedLoopUsers()), User());
+		for (User& user : users) {
+			user.thinkUntil = startTick + static_cast<uint64_t>(drawExponential(thinkTicks));
+		}
+		clock->schedulePeriodic(arrivalTimer, 1, [this]() { pollUsers(); });
+	}
+	else if (model == "batch") {
+		armLocked();
+	}
+	else if (rate > 0) {
+		drawNextLocked();
+		armLocked();
+	}
+}
+
+void ArrivalGenerator::stop() {
+	std::lock_guard<std::mutex> lock(generatorMutex);
+	running = false;
+	TimerWheel::getInstance()->cancel(arrivalTimer);
+	users.clear();
+}
+
+double ArrivalGenerator::drawExponential(double mean) {
+	return -mean * std::log(1.0 - Random::getInstance()->nextDouble(Random::ARRIVALS));
+}
+
+// Move nextArrival to the following arrival of the open-loop model
+void ArrivalGenerator::drawNextLocked() {
+	if (model == "batch") {
+		nextArrival += static_cast<double>(batchTicks);
+		return;
+	}
+
+	while (true) {
+		nextArrival += drawExponential(1.0 / rate);
+
+		if (model == "on-off") {
+			// Gaps are memoryless, so an arrival drawn into a quiet spell restarts at the next burst
+			double cycle = static_cast<double>(burstOnTicks + burstOffTicks);
+			double phase = std::fmod(nextArrival, cycle);
+			if (phase >= burstOnTicks) {
+				nextArrival += cycle - phase;
+				continue;
+			}
+		}
+		else if (model == "diurnal") {
+			// Thinning: keep a peak-rate arrival with probability rate(t) / peak
+			double level = (1.0 - std::cos(2 * PI * nextArrival / diurnalPeriod)) / 2;
+			if (Random::getInstance()->nextDouble(Random::ARRIVALS) >= level) {
+				continue;
+			}
+		}
+		return;
+	}
+}
+
+void ArrivalGenerator::armLocked() {
+	uint64_t due = startTick + static_cast<uint64_t>(std::ceil(nextArrival));
+	uint64_t now = TimerWheel::getInstance()->getCurrentTick();
+	TimerWheel::getInstance()->schedule(arrivalTimer, due > now ? due - now : 1, [this]() { arrive(); });
+}
+
+// Several arrivals can fall in one tick at high rates
+void ArrivalGenerator::arrive() {
+	std::lock_guard<std::mutex> lock(generatorMutex);
+	if (!running) {
+		return;
+	}
+
+	double now = static_cast<double>(TimerWheel::getInstance()->getCurrentTick() - startTick);
+	do {
+		for (int i = 0; i < (model == "batch" ? batchSize : 1); i++) {
+			ConsoleManager::getInstance()->createTestProcess();
+		}
+		drawNextLocked();
+	} while (nextArrival <= now);
+	armLocked();
+}
+
+void ArrivalGenerator::pollUsers() {
+	std::lock_guard<std::mutex> lock(generatorMutex);
+	if (!running) {
+		return;
+	}
+
+	uint64_t now = TimerWheel::getInstance()->getCurrentTick();
+	for (User& user : users) {
+		if (user.process && user.process->isFinished()) {
+			user.process = nullptr;
+			user.thinkUntil = now + static_cast<uint64_t>(std::llround(drawExponential(thinkTicks)));
+		}
+		if (!user.process && now >= user.thinkUntil) {
+			user.process = ConsoleManager::getInstance()->createTestProcess();
+		}
+	}
+}
+
+int ArrivalGenerator::drawInstructions() {
+	ConsoleManager* console = ConsoleManager::getInstance();
+	Random* random = Random::getInstance();
+	int minIns = console->getMinIns();
+	int maxIns = std::max(minIns, console->getMaxIns());
+	std::string distribution = console->getSizeDistribution();
+
+	if (distribution == "lognormal") {
+		// Box-Muller for a standard normal
+		double u1 = random->nextDouble(Random::SIZES);
+		double u2 = random->nextDouble(Random::SIZES);
+		double z = std::sqrt(-2 * std::log(1.0 - u1)) * std::cos(2 * PI * u2);
+		double median = std::sqrt(std::max(1.0, static_cast<double>(minIns)) * maxIns);
+		double size = median * std::exp(console->getSizeSigma() * z);
+		return static_cast<int>(std::clamp(size, static_cast<double>(minIns), static_cast<double>(maxIns)));
+	}
+	if (distribution == "bimodal") {
+		int tenth = (maxIns - minIns) / 10;
+		if (random->nextDouble(Random::SIZES) < console->getSizeBimodalFraction()) {
+			return random->nextUniform(Random::SIZES, minIns, minIns + tenth);
+		}
+		return random->nextUniform(Random::SIZES, maxIns - tenth, maxIns);
+	}
+	return random->nextUniform(Random::SIZES, minIns, maxIns);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+
+#include "TimerWheel.h"
+
+class Process;
+
+// Process arrivals for scheduler-test, scheduled on the sim clock (arrival-model in config.txt):
+//   poisson      exponential gaps, arrival-rate processes per 1000 ticks on average
+//   on-off       poisson during burst-on-ticks, then nothing for burst-off-ticks, repeating
+//   diurnal      poisson whose rate ramps from 0 up to arrival-rate and back every diurnal-period ticks
+//   closed-loop  closed-loop-users users each submit a process, wait for it to finish and think
+//                for think-ticks on average (exponential) before submitting the next
+//   batch        batch-process-freq processes every second's worth of sim ticks; only used in
+//                lockstep, since otherwise scheduler-test adds a batch every wall-clock second
+// Arrivals start on the clock thread at the next exec tick, so in lockstep a run does not depend
+// on when the console thread happened to call start().
+class ArrivalGenerator
+{
+public:
+	static bool isKnownModel(const std::string& model);
+	static bool isKnownDistribution(const std::string& distribution);
+
+	void start();
+	void stop();
+
+	// Instruction count of a new process from size-distribution, within min-ins and max-ins:
+	//   uniform    any count equally likely
+	//   lognormal  median sqrt(min-ins * max-ins), log standard deviation size-sigma
+	//   bimodal    size-bimodal-fraction short jobs in the lowest tenth of the range, the rest in the highest
+	static int drawInstructions();
+
+private:
+	struct User
+	{
+		std::shared_ptr<Process> process;	// In flight, or null while thinking
+		uint64_t thinkUntil = 0;
+	};
+
+	static double drawExponential(double mean);
+
+	void begin();
+	void drawNextLocked();
+	void armLocked();
+	void arrive();
+	void pollUsers();
+
+	std::mutex generatorMutex;
+	TimerWheel::Timer arrivalTimer;
+	bool running = false;
+
+	std::string model;
+	double rate = 0;	// Per tick
+	uint64_t startTick = 0;
+	double nextArrival = 0;	// Ticks since startTick
+	uint64_t burstOnTicks = 0;
+	uint64_t burstOffTicks = 0;
+	uint64_t diurnalPeriod = 0;
+	double thinkTicks = 0;
+	uint64_t batchTicks = 0;
+	int batchSize = 0;
+	std::vector<User> users;
+};
@@ -0,0 +1,205 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <thread>
+
+#include "Benchmark.h"
+#include "ConsoleColor.h"
+#include "PageTable.h"
+#include "Interpreter.h"
+#include "Process.h"
+#include "ObjectPool.h"
+#include "Machine.h"
+#include "ConsoleManager.h"
+
+using namespace std;
+
+// Keeps the optimizer from dropping benchmark loops whose results are otherwise unused
+volatile size_t benchmarkSink = 0;
+
+void Benchmark::run(const std::string& name) {
+	if (name == "page-table") {
+		pageTable();
+	}
+	else if (name == "interpreter") {
+		interpreter();
+	}
+	else if (name == "process-alloc") {
+		processAlloc();
+	}
+	else {
+		cout << ConsoleColor::RED << "Unknown benchmark: " << name << ConsoleColor::RESET << endl;
+		cout << "Available benchmarks: page-table, interpreter, process-alloc" << endl;
+	}
+}
+
+// Translation cost and host memory of flat vs multi-level page tables
+// for a large, sparsely touched virtual address space
+void Benchmark::pageTable() {
+	const size_t numVirtualPages = size_t(1) << 20;	// 4 GB of 4 KB pages
+	const size_t numClusters = 64;
+	const size_t pagesPerCluster = 64;
+	const size_t numLookups = 5000000;
+
+	// Touched pages come in clusters scattered over the address space
+	std::mt19937 gen(42);
+	std::uniform_int_distribution<size_t> clusterStart(0, numVirtualPages - pagesPerCluster);
+	std::vector<size_t> touchedPages;
+	for (size_t c = 0; c < numClusters; c++) {
+		size_t start = clusterStart(gen);
+		for (size_t p = 0; p < pagesPerCluster; p++) {
+			touchedPages.push_back(start + p);
+		}
+	}
+
+	std::vector<size_t> lookups(numLookups);
+	std::uniform_int_distribution<size_t> pick(0, touchedPages.size() - 1);
+	for (size_t& page : lookups) {
+		page = touchedPages[pick(gen)];
+	}
+
+	cout << "Virtual pages: " << numVirtualPages << ", touched pages: " << touchedPages.size() << endl;
+	cout << left << setw(8) << "levels" << setw(16) << "host bytes" << setw(16) << "map ns/page" << "translate ns/op" << endl;
+
+	for (int levels = 1; levels <= 3; levels++) {
+		auto mapStart = chrono::steady_clock::now();
+		PageTable pageTable(numVirtualPages, levels);
+		for (size_t i = 0; i < touchedPages.size(); i++) {
+			pageTable.map(touchedPages[i], i);
+		}
+		auto mapEnd = chrono::steady_clock::now();
+
+		size_t checksum = 0;
+		auto translateStart = chrono::steady_clock::now();
+		for (size_t page : lookups) {
+			checksum += pageTable.translate(page);
+		}
+		auto translateEnd = chrono::steady_clock::now();
+
+		double mapNs = chrono::duration<double, nano>(mapEnd - mapStart).count() / touchedPages.size();
+		double translateNs = chrono::duration<double, nano>(translateEnd - translateStart).count() / numLookups;
+
+		cout << left << setw(8) << levels << setw(16) << pageTable.getHostMemory()
+			<< setw(16) << fixed << setprecision(2) << mapNs << translateNs << endl;
+		benchmarkSink = checksum;
+	}
+	cout << defaultfloat << setprecision(6) << endl;
+}
+
+namespace {
+	// Variables in a host array, so the interpreter benchmark measures dispatch rather than the allocators
+	class HostVariableStore : public VariableStore
+	{
+	public:
+		bool readVariable(int slot, uint16_t& value) override {
+			value = variables[slot];
+			return true;
+		}
+
+		bool writeVariable(int slot, uint16_t value) override {
+			variables[slot] = value;
+			return true;
+		}
+
+		uint16_t variables[ExecutionState::MAX_VARIABLES] = {};
+	};
+}
+
+// Bytecode instructions per second per core, with one interpreter thread per simulated core
+void Benchmark::interpreter() {
+	const int numInstructions = 2000000;
+	unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+	cout << left << setw(8) << "cores" << setw(20) << "instructions/s/core" << "total instructions/s" << endl;
+
+	for (unsigned int numThreads = 1; numThreads <= maxThreads; numThreads *= 2) {
+		std::vector<double> perCore(numThreads);
+		std::vector<std::thread> threads;
+
+		for (unsigned int t = 0; t < numThreads; t++) {
+			threads.emplace_back([&perCore, t]() {
+				Interpreter interpreter;
+				HostVariableStore variables;
+				ExecutionState state;
+				state.program = ProgramGenerator::generate(t + 1, numInstructions);
+				state.memory = &variables;
+
+				// Sleeps are skipped: only the dispatch loop is measured
+				auto start = chrono::steady_clock::now();
+				while (interpreter.step(state) == Interpreter::EXECUTED) {
+					state.sleepTicks = 0;
+				}
+				auto end = chrono::steady_clock::now();
+
+				perCore[t] = interpreter.getInstructionsExecuted() / chrono::duration<double>(end - start).count();
+				benchmarkSink = variables.variables[0];
+				});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+
+		double total = 0;
+		for (double ips : perCore) {
+			total += ips;
+		}
+		cout << left << setw(8) << numThreads << setw(20) << fixed << setprecision(0) << total / numThreads << total << endl;
+	}
+	cout << defaultfloat << setprecision(6) << endl;
+}
+
+// Batches of processes created and released through make_shared vs the object pool.
+// The processes live on a scratch machine so they never reach the console's process table.
+// Heap allocation counts need a counting operator new, so only basicOS-bench reports them.
+void Benchmark::processAlloc() {
+	const int batchSize = 1000;
+	const int numBatches = 50;
+
+	Machine scratch;
+	scratch.enter();
+	ConsoleManager::initialize(false);
+
+	std::vector<std::string> names;
+	for (int i = 0; i < batchSize; i++) {
+		names.push_back("bench" + std::to_string(i));
+	}
+
+	auto runBatches = [&](auto create) {
+		std::vector<std::shared_ptr<Process>> batch;
+		batch.reserve(batchSize);
+
+		auto start = chrono::steady_clock::now();
+		for (int b = 0; b < numBatches; b++) {
+			for (int i = 0; i < batchSize; i++) {
+				batch.push_back(create(names[i]));
+			}
+			benchmarkSink = batch.back()->getPid();
+			batch.clear();
+		}
+		auto end = chrono::steady_clock::now();
+		return chrono::duration<double, nano>(end - start).count() / (batchSize * numBatches);
+	};
+
+	double heapNs = runBatches([](const std::string& name) {
+		return std::make_shared<Process>(name, 0, time(nullptr), 0);
+		});
+
+	ObjectPool* pool = ObjectPool::getInstance();
+	size_t allocationsBefore = pool->getNumAllocations();
+	size_t reusedBefore = pool->getNumReused();
+
+	double poolNs = runBatches([](const std::string& name) {
+		return makePooled<Process>(name, 0, time(nullptr), 0);
+		});
+
+	cout << "Processes: " << numBatches << " batches of " << batchSize << endl;
+	cout << left << setw(14) << "allocator" << setw(14) << "ns/process" << "reused blocks" << endl;
+	cout << left << setw(14) << "make_shared" << setw(14) << fixed << setprecision(1) << heapNs << 0 << endl;
+	cout << left << setw(14) << "pool" << setw(14) << poolNs << pool->getNumReused() - reusedBefore
+		<< " of " << pool->getNumAllocations() - allocationsBefore << endl;
+	cout << defaultfloat << setprecision(6) << endl;
+
+	Machine::leave();
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+
+class Benchmark
+{
+public:
+	static void run(const std::string& name);
+
+	static void pageTable();
+	static void interpreter();
+	static void processAlloc();
+};
@@ -0,0 +1,81 @@
+#include <algorithm>
+
+#include "Bytecode.h"
+
+using namespace std;
+
+namespace {
+	// xorshift32: cheap and good enough to shape random programs
+	uint32_t nextRandom(uint32_t& state) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+}
+
+// Build a random program that executes exactly numInstructions instructions,
+// about ioPercent of them blocking IO requests.
+// FOR and END_FOR only steer control flow and are not counted.
+std::vector<Bytecode> ProgramGenerator::generate(uint32_t seed, int numInstructions, int ioPercent) {
+	std::vector<Bytecode> program;
+	program.reserve(numInstructions);
+
+	uint32_t state = seed == 0 ? 0x9E3779B9u : seed;
+	generateBlock(program, state, numInstructions, 0, ioPercent);
+	program.shrink_to_fit();
+	return program;
+}
+
+void ProgramGenerator::generateBlock(std::vector<Bytecode>& program, uint32_t& state, int budget, int depth, int ioPercent) {
+	while (budget > 0) {
+		if (ioPercent > 0 && static_cast<int>(nextRandom(state) % 100) < ioPercent) {
+			program.push_back({ Instruction::IO, Bytecode::IMMEDIATE_1, 0, 0, static_cast<uint16_t>(nextRandom(state) % 256), 0 });
+			budget--;
+			continue;
+		}
+
+		uint32_t choice = nextRandom(state) % 16;
+
+		// Loop: count iterations of a body that executes bodyBudget instructions
+		if (choice == 0 && depth < ExecutionState::MAX_LOOP_DEPTH && budget >= 4) {
+			int count = 2 + nextRandom(state) % 3;
+			int bodyBudget = 1 + nextRandom(state) % std::min(8, budget / count);
+
+			size_t forIndex = program.size();
+			program.push_back({ Instruction::FOR, 0, 0, 0, static_cast<uint16_t>(count), 0 });
+			generateBlock(program, state, bodyBudget, depth + 1, ioPercent);
+			program[forIndex].operand2 = static_cast<uint16_t>(program.size() - forIndex - 1);
+			program.push_back({ Instruction::END_FOR, 0, 0, 0, 0, 0 });
+
+			budget -= count * bodyBudget;
+			continue;
+		}
+
+		uint8_t dest = nextRandom(state) % ExecutionState::MAX_VARIABLES;
+		uint16_t operand1 = static_cast<uint16_t>(nextRandom(state));
+		uint16_t operand2 = static_cast<uint16_t>(nextRandom(state));
+
+		if (choice < 4) {
+			program.push_back({ Instruction::DECLARE, Bytecode::IMMEDIATE_1, dest, 0, static_cast<uint16_t>(operand1 % 256), 0 });
+		}
+		else if (choice < 8) {
+			// Second operand is a small constant half of the time, another variable otherwise
+			uint8_t flags = (choice & 1) ? Bytecode::IMMEDIATE_2 : 0;
+			program.push_back({ Instruction::ADD, flags, dest, 0, static_cast<uint16_t>(operand1 % ExecutionState::MAX_VARIABLES),
+				static_cast<uint16_t>(flags ? operand2 % 256 : operand2 % ExecutionState::MAX_VARIABLES) });
+		}
+		else if (choice < 11) {
+			uint8_t flags = (choice & 1) ? Bytecode::IMMEDIATE_2 : 0;
+			program.push_back({ Instruction::SUBTRACT, flags, dest, 0, static_cast<uint16_t>(operand1 % ExecutionState::MAX_VARIABLES),
+				static_cast<uint16_t>(flags ? operand2 % 256 : operand2 % ExecutionState::MAX_VARIABLES) });
+		}
+		else if (choice < 12) {
+			program.push_back({ Instruction::SLEEP, Bytecode::IMMEDIATE_1, 0, 0, static_cast<uint16_t>(1 + operand1 % 4), 0 });
+		}
+		else {
+			program.push_back({ Instruction::PRINT, 0, 0, 0, dest, 0 });
+		}
+		budget--;
+	}
+}
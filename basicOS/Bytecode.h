@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Instruction.h"
+
+// One compiled instruction. Operands are variable slots unless the matching
+// IMMEDIATE flag is set, in which case they hold the value itself.
+struct Bytecode
+{
+	static const uint8_t IMMEDIATE_1 = 1;
+	static const uint8_t IMMEDIATE_2 = 2;
+
+	uint8_t opcode;		// Instruction::CommandType
+	uint8_t flags;
+	uint8_t dest;		// variable slot written by DECLARE, ADD and SUBTRACT
+	uint8_t reserved;
+	uint16_t operand1;	// FOR: repeat count, SLEEP: ticks, PRINT: variable slot, IO: device
+	uint16_t operand2;	// FOR: body length
+};
+
+static_assert(sizeof(Bytecode) == 8, "Bytecode should stay packed into 8 bytes");
+
+// Backing storage for a process's variables. Processes keep their symbol table in
+// their own simulated memory, so every access goes through the memory allocator.
+class VariableStore
+{
+public:
+	virtual ~VariableStore() = default;
+	virtual bool readVariable(int slot, uint16_t& value) = 0;
+	virtual bool writeVariable(int slot, uint16_t value) = 0;
+};
+
+// Interpreter state carried by each process between ticks
+struct ExecutionState
+{
+	static const int MAX_VARIABLES = 32;
+	static const int SYMBOL_TABLE_SIZE = MAX_VARIABLES * sizeof(uint16_t);	// Bytes from address 0
+	static const int MAX_LOOP_DEPTH = 3;
+	static const int LOG_SIZE = 8;
+	static const int MAX_STALLS = 1000;	// Ticks an instruction may wait for memory before the process faults
+
+	struct LoopFrame
+	{
+		uint32_t start;
+		uint16_t remaining;
+	};
+
+	struct LogEntry
+	{
+		int line;
+		uint8_t variable;
+		uint16_t value;
+	};
+
+	std::vector<Bytecode> program;
+	uint32_t programCounter = 0;
+	LoopFrame loops[MAX_LOOP_DEPTH] = {};
+	uint8_t loopDepth = 0;
+	VariableStore* memory = nullptr;
+	bool symbolTableInitialized = false;
+	int stalls = 0;	// Consecutive ticks the current instruction could not access its variables
+	bool faulted = false;
+	int sleepTicks = 0;
+	uint16_t ioDevice = 0;	// Device of the last IO instruction
+	int executed = 0;
+
+	// Last PRINT outputs, formatted only when shown
+	LogEntry logs[LOG_SIZE] = {};
+	int numLogs = 0;
+};
+
+class ProgramGenerator
+{
+public:
+	static std::vector<Bytecode> generate(uint32_t seed, int numInstructions, int ioPercent = 0);
+
+private:
+	static void generateBlock(std::vector<Bytecode>& program, uint32_t& state, int budget, int depth, int ioPercent);
+};
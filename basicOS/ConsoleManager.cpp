@@ -2,12 +2,27 @@
 
 #include <iostream>
 #include <unordered_map>
-#include <random>
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <stdexcept>
 
 #include "Process.h"
+#include "ObjectPool.h"
+#include "ProcessRegistry.h"
+#include "ProcessHistory.h"
+#include "ProcessTable.h"
 #include "ConsoleManager.h"
 #include "FlatMemoryAllocator.h"
 #include "PagingAllocator.h"
+#include "SwapPool.h"
+#include "TimerWheel.h"
+#include "Telemetry.h"
+#include "LatencyStats.h"
+#include "Profiler.h"
+#include "Platform.h"
+#include "Random.h"
+#include "Machine.h"
 
 using namespace std;
 
@@ -18,29 +33,42 @@ ConsoleManager::ConsoleManager() {
 
 ConsoleManager* ConsoleManager::getInstance()
 {
-    return consoleManager;
+    return Machine::slot(&Machine::consoleManager, consoleManager);
 }
 
-void ConsoleManager::initialize() {
-    consoleManager = new ConsoleManager();
-    ConsoleManager::getInstance()->initializeConfiguration();
+// Without loadConfiguration every setting keeps its default until set through the setters
+void ConsoleManager::initialize(bool loadConfiguration) {
+    Machine::slot(&Machine::consoleManager, consoleManager) = new ConsoleManager();
+    if (loadConfiguration) {
+        ConsoleManager::getInstance()->initializeConfiguration();
+    }
 }
 
 void ConsoleManager::drawConsole() {
+    PROFILE_ZONE(RENDER);
     if (this->switchSuccessful) {
-        system("cls");
+        system(CLEAR_SCREEN_COMMAND);
         string consoleName = this->getCurrentConsole()->getConsoleName();
 
         if (this->getCurrentConsole()->getConsoleName() == MAIN_CONSOLE) {
             this->printHeader();
         }
         else {
-            if (this->screenMap.contains(consoleName)) {
-                cout << "Screen Name: " << this->screenMap[consoleName]->getConsoleName() << endl;
+            shared_ptr<ProcessScreen> screen = this->getCurrentConsole();
+            if (screen) {
+                cout << "Screen Name: " << screen->getConsoleName() << endl;
                 cout << "Current line of instruction / Total line of instruction: ";
-                cout << this->screenMap[consoleName]->getCurrentLine();
-                cout << "/" << this->screenMap[consoleName]->getTotalLine() << endl;
-                cout << "Timestamp: " << this->screenMap[consoleName]->getTimestamp() << endl;
+                cout << screen->getCurrentLine();
+                cout << "/" << screen->getTotalLine() << endl;
+                cout << "Timestamp: " << screen->getTimestamp() << endl;
+
+                // Recent PRINT output of the process
+                shared_ptr<Process> process = dynamic_pointer_cast<Process>(screen);
+                if (process) {
+                    for (const ExecutionState::LogEntry& entry : process->getRecentLogs()) {
+                        cout << "Line " << entry.line << ": Value from v" << int(entry.variable) << " = " << entry.value << endl;
+                    }
+                }
             }
         }
     }
@@ -66,10 +94,11 @@ void ConsoleManager::destroy() {
 void ConsoleManager::exitApplication() {
     this->running = false;
     Scheduler::getInstance()->stop();
+    PagingAllocator::getInstance()->stopPageMerging();
 }
 
 // Configuration getters and setters
-void ConsoleManager::initializeConfiguration() {
+void ConsoleManager::initializeConfiguration(const std::vector<std::pair<string, string>>& overrides) {
     FILE* file;
     errno_t err = fopen_s(&file, "config.txt", "r");
     if (err != 0) {
@@ -88,54 +117,166 @@ void ConsoleManager::initializeConfiguration() {
             string value = str.substr(space_pos + 1);
             value.erase(remove(value.begin(), value.end(), '\n'), value.end());
 
-            if (key == "num-cpu") {
-                ConsoleManager::getInstance()->setNumCpu(stoi(value));
-            }
-            else if (key == "scheduler") {
-                value.erase(remove(value.begin(), value.end(), '\"'), value.end()); 
-                ConsoleManager::getInstance()->setSchedulerConfig(value);
-            }
-            else if (key == "quantum-cycles") {
-                ConsoleManager::getInstance()->setTimeSlice(stoi(value));
-            }
-            else if (key == "min-ins") {
-                ConsoleManager::getInstance()->setMinIns(stoi(value));
-            }
-            else if (key == "max-ins") {
-                ConsoleManager::getInstance()->setMaxIns(stoi(value));
-            }
-            else if (key == "delay-per-exec") {
-                ConsoleManager::getInstance()->setDelayPerExec(stoi(value));
-            }
-            else if (key == "batch-process-freq") {
-                ConsoleManager::getInstance()->setBatchProcessFrequency(stoi(value));
-            } 
-            else if (key == "max-overall-mem") {
-				ConsoleManager::getInstance()->setMaxOverallMem(stoi(value));
-            }
-            else if (key == "mem-per-frame") {
-                ConsoleManager::getInstance()->setMemPerFrame(stoi(value));
-            }
-            else if (key == "min-mem-per-proc") {
-				ConsoleManager::getInstance()->setMinMemPerProc(stoi(value));
-			}
-			else if (key == "max-mem-per-proc") {
-				ConsoleManager::getInstance()->setMaxMemPerProc(stoi(value));
-            }
-           
+            setConfiguration(key, value);
         }
         fclose(file);
     }
 
+    // A sweep varies settings on top of config.txt
+    for (const auto& setting : overrides) {
+        setConfiguration(setting.first, setting.second);
+    }
 
-	Scheduler* scheduler = Scheduler::getInstance();
-
+    // Every random draw below and in the processes comes from this seed
+    Random::initialize(this->seed);
     setNumPages();
 }
 
+// Apply one config.txt setting; false for an unknown key
+bool ConsoleManager::setConfiguration(const string& key, string value) {
+    if (key == "num-cpu") {
+        ConsoleManager::getInstance()->setNumCpu(stoi(value));
+    }
+    else if (key == "scheduler") {
+        value.erase(remove(value.begin(), value.end(), '\"'), value.end()); 
+        ConsoleManager::getInstance()->setSchedulerConfig(value);
+    }
+    else if (key == "quantum-cycles") {
+        ConsoleManager::getInstance()->setTimeSlice(stoi(value));
+    }
+    else if (key == "min-ins") {
+        ConsoleManager::getInstance()->setMinIns(stoi(value));
+    }
+    else if (key == "max-ins") {
+        ConsoleManager::getInstance()->setMaxIns(stoi(value));
+    }
+    else if (key == "delay-per-exec") {
+        ConsoleManager::getInstance()->setDelayPerExec(stoi(value));
+    }
+    else if (key == "batch-process-freq") {
+        ConsoleManager::getInstance()->setBatchProcessFrequency(stoi(value));
+    } 
+    else if (key == "max-overall-mem") {
+		ConsoleManager::getInstance()->setMaxOverallMem(stoi(value));
+    }
+    else if (key == "mem-per-frame") {
+        ConsoleManager::getInstance()->setMemPerFrame(stoi(value));
+    }
+    else if (key == "min-mem-per-proc") {
+		ConsoleManager::getInstance()->setMinMemPerProc(stoi(value));
+    }
+    else if (key == "max-mem-per-proc") {
+		ConsoleManager::getInstance()->setMaxMemPerProc(stoi(value));
+    }
+    else if (key == "page-merge-interval") {
+        ConsoleManager::getInstance()->setPageMergeInterval(stoi(value));
+    }
+    else if (key == "page-table-levels") {
+        ConsoleManager::getInstance()->setPageTableLevels(stoi(value));
+    }
+    else if (key == "virtual-mem-per-proc") {
+        ConsoleManager::getInstance()->setVirtualMemPerProc(stoull(value));
+    }
+    else if (key == "swap-pool-size") {
+        ConsoleManager::getInstance()->setSwapPoolSize(stoull(value));
+    }
+    else if (key == "swap-directory") {
+        ConsoleManager::getInstance()->setSwapDirectory(value);
+    }
+    else if (key == "io-frequency") {
+        ConsoleManager::getInstance()->setIoFrequency(stoi(value));
+    }
+    else if (key == "io-latency") {
+        ConsoleManager::getInstance()->setIoLatency(stoi(value));
+    }
+    else if (key == "num-io-devices") {
+        ConsoleManager::getInstance()->setNumIoDevices(stoi(value));
+    }
+    else if (key == "tick-duration-ms") {
+        ConsoleManager::getInstance()->setTickDuration(stoi(value));
+    }
+    else if (key == "snapshot-interval") {
+        ConsoleManager::getInstance()->setSnapshotInterval(stoi(value));
+    }
+    else if (key == "executor-threads") {
+        ConsoleManager::getInstance()->setExecutorThreads(stoi(value));
+    }
+    else if (key == "telemetry-interval") {
+        ConsoleManager::getInstance()->setTelemetryInterval(stoi(value));
+    }
+    else if (key == "telemetry-capacity") {
+        ConsoleManager::getInstance()->setTelemetryCapacity(stoull(value));
+    }
+    else if (key == "trace-buffer-events") {
+        ConsoleManager::getInstance()->setTraceBufferEvents(stoull(value));
+    }
+    else if (key == "seed") {
+        ConsoleManager::getInstance()->setSeed(stoull(value));
+    }
+    else if (key == "lockstep") {
+        ConsoleManager::getInstance()->setLockstep(stoi(value) != 0);
+    }
+    else if (key == "arrival-model") {
+        value.erase(remove(value.begin(), value.end(), '\"'), value.end());
+        ConsoleManager::getInstance()->setArrivalModel(value);
+    }
+    else if (key == "arrival-rate") {
+        ConsoleManager::getInstance()->setArrivalRate(stod(value));
+    }
+    else if (key == "burst-on-ticks") {
+        ConsoleManager::getInstance()->setBurstOnTicks(stoi(value));
+    }
+    else if (key == "burst-off-ticks") {
+        ConsoleManager::getInstance()->setBurstOffTicks(stoi(value));
+    }
+    else if (key == "diurnal-period") {
+        ConsoleManager::getInstance()->setDiurnalPeriod(stoi(value));
+    }
+    else if (key == "closed-loop-users") {
+        ConsoleManager::getInstance()->setClosedLoopUsers(stoi(value));
+    }
+    else if (key == "think-ticks") {
+        ConsoleManager::getInstance()->setThinkTicks(stoi(value));
+    }
+    else if (key == "size-distribution") {
+        value.erase(remove(value.begin(), value.end(), '\"'), value.end());
+        ConsoleManager::getInstance()->setSizeDistribution(value);
+    }
+    else if (key == "size-sigma") {
+        ConsoleManager::getInstance()->setSizeSigma(stod(value));
+    }
+    else if (key == "size-bimodal-fraction") {
+        ConsoleManager::getInstance()->setSizeBimodalFraction(stod(value));
+    }
+    else if (key == "core-speeds") {
+        // Comma-separated instructions per tick, e.g. 2,2,1,1 for two big and two little cores
+        std::vector<double> speeds;
+        std::stringstream speedStream(value);
+        string speed;
+        while (getline(speedStream, speed, ',')) {
+            speeds.push_back(stod(speed));
+            if (speeds.back() <= 0) {
+                throw std::invalid_argument("core speeds must be positive");
+            }
+        }
+        if (speeds.empty()) {
+            throw std::invalid_argument("no core speeds");
+        }
+        ConsoleManager::getInstance()->setCoreSpeeds(speeds);
+    }
+    else if (key == "capacity-aware") {
+        ConsoleManager::getInstance()->setCapacityAware(stoi(value) != 0);
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
 void ConsoleManager::initializeAllocators() {
     FlatMemoryAllocator::initialize(ConsoleManager::getInstance()->getMaxOverallMem());
     PagingAllocator::initialize(ConsoleManager::getInstance()->getMaxOverallMem());
+    SwapPool::initialize(ConsoleManager::getInstance()->getSwapPoolSize(), ConsoleManager::getInstance()->getSwapDirectory());
 }
 
 // getters
@@ -183,6 +324,118 @@ size_t ConsoleManager::getMaxMemPerProc() {
     return this->maxMemPerProc;
 }
 
+int ConsoleManager::getPageMergeInterval() {
+    return this->pageMergeInterval;
+}
+
+int ConsoleManager::getPageTableLevels() {
+    return this->pageTableLevels;
+}
+
+size_t ConsoleManager::getVirtualMemPerProc() {
+    return this->virtualMemPerProc;
+}
+
+size_t ConsoleManager::getSwapPoolSize() {
+    return this->swapPoolSize;
+}
+
+string ConsoleManager::getSwapDirectory() {
+    return this->swapDirectory;
+}
+
+int ConsoleManager::getIoFrequency() {
+    return this->ioFrequency;
+}
+
+int ConsoleManager::getIoLatency() {
+    return this->ioLatency;
+}
+
+int ConsoleManager::getNumIoDevices() {
+    return this->numIoDevices;
+}
+
+int ConsoleManager::getTickDuration() {
+    return this->tickDuration;
+}
+
+int ConsoleManager::getSnapshotInterval() {
+    return this->snapshotInterval;
+}
+
+int ConsoleManager::getExecutorThreads() {
+    return this->executorThreads;
+}
+
+int ConsoleManager::getTelemetryInterval() {
+    return this->telemetryInterval;
+}
+
+size_t ConsoleManager::getTelemetryCapacity() {
+    return this->telemetryCapacity;
+}
+
+size_t ConsoleManager::getTraceBufferEvents() {
+    return this->traceBufferEvents;
+}
+
+uint64_t ConsoleManager::getSeed() {
+    return this->seed;
+}
+
+bool ConsoleManager::getLockstep() {
+    return this->lockstep;
+}
+
+string ConsoleManager::getArrivalModel() {
+    return this->arrivalModel;
+}
+
+double ConsoleManager::getArrivalRate() {
+    return this->arrivalRate;
+}
+
+int ConsoleManager::getBurstOnTicks() {
+    return this->burstOnTicks;
+}
+
+int ConsoleManager::getBurstOffTicks() {
+    return this->burstOffTicks;
+}
+
+int ConsoleManager::getDiurnalPeriod() {
+    return this->diurnalPeriod;
+}
+
+int ConsoleManager::getClosedLoopUsers() {
+    return this->closedLoopUsers;
+}
+
+int ConsoleManager::getThinkTicks() {
+    return this->thinkTicks;
+}
+
+string ConsoleManager::getSizeDistribution() {
+    return this->sizeDistribution;
+}
+
+double ConsoleManager::getSizeSigma() {
+    return this->sizeSigma;
+}
+
+double ConsoleManager::getSizeBimodalFraction() {
+    return this->sizeBimodalFraction;
+}
+
+std::vector<double> ConsoleManager::getCoreSpeeds() {
+    return this->coreSpeeds;
+}
+
+bool ConsoleManager::getCapacityAware() {
+    return this->capacityAware;
+}
+
 //setters
 void ConsoleManager::setNumCpu(int num_cpu) {
     this->num_cpu = num_cpu;
@@ -228,21 +481,121 @@ void ConsoleManager::setMaxMemPerProc(size_t maxMemPerProc) {
     this->maxMemPerProc = maxMemPerProc;
 }
 
-//Process Screen
-std::shared_ptr<Process> ConsoleManager::getScreenByProcessName(const std::string& processName) {
-    unordered_map<string, shared_ptr<ProcessScreen>> screenMap = ConsoleManager::getInstance()->getScreenMap();
-    auto it = screenMap.find(processName);
-    if (it != screenMap.end()) {
-        std::shared_ptr<Process> process = std::dynamic_pointer_cast<Process>(it->second);
-        if (process) {
-            return process;
-        }
-    }
-    return nullptr;
+void ConsoleManager::setPageMergeInterval(int pageMergeInterval) {
+    this->pageMergeInterval = pageMergeInterval;
+}
+
+void ConsoleManager::setPageTableLevels(int pageTableLevels) {
+    this->pageTableLevels = pageTableLevels;
+}
+
+void ConsoleManager::setVirtualMemPerProc(size_t virtualMemPerProc) {
+    this->virtualMemPerProc = virtualMemPerProc;
+}
+
+void ConsoleManager::setSwapPoolSize(size_t swapPoolSize) {
+    this->swapPoolSize = swapPoolSize;
+}
+
+void ConsoleManager::setSwapDirectory(const string& swapDirectory) {
+    this->swapDirectory = swapDirectory;
+}
+
+void ConsoleManager::setIoFrequency(int ioFrequency) {
+    this->ioFrequency = ioFrequency;
+}
+
+void ConsoleManager::setIoLatency(int ioLatency) {
+    this->ioLatency = ioLatency;
+}
+
+void ConsoleManager::setNumIoDevices(int numIoDevices) {
+    this->numIoDevices = numIoDevices;
+}
+
+void ConsoleManager::setTickDuration(int tickDuration) {
+    this->tickDuration = tickDuration;
+}
+
+void ConsoleManager::setSnapshotInterval(int snapshotInterval) {
+    this->snapshotInterval = snapshotInterval;
+}
+
+void ConsoleManager::setExecutorThreads(int executorThreads) {
+    this->executorThreads = executorThreads;
+}
+
+void ConsoleManager::setTelemetryInterval(int telemetryInterval) {
+    this->telemetryInterval = telemetryInterval;
+}
+
+void ConsoleManager::setTelemetryCapacity(size_t telemetryCapacity) {
+    this->telemetryCapacity = telemetryCapacity;
+}
+
+void ConsoleManager::setTraceBufferEvents(size_t traceBufferEvents) {
+    this->traceBufferEvents = traceBufferEvents;
+}
+
+void ConsoleManager::setSeed(uint64_t seed) {
+    this->seed = seed;
 }
 
-unordered_map<string, shared_ptr<ProcessScreen>> ConsoleManager::getScreenMap() {
-    return this->screenMap;
+void ConsoleManager::setLockstep(bool lockstep) {
+    this->lockstep = lockstep;
+}
+
+void ConsoleManager::setArrivalModel(const string& arrivalModel) {
+    this->arrivalModel = arrivalModel;
+}
+
+void ConsoleManager::setArrivalRate(double arrivalRate) {
+    this->arrivalRate = arrivalRate;
+}
+
+void ConsoleManager::setBurstOnTicks(int burstOnTicks) {
+    this->burstOnTicks = burstOnTicks;
+}
+
+void ConsoleManager::setBurstOffTicks(int burstOffTicks) {
+    this->burstOffTicks = burstOffTicks;
+}
+
+void ConsoleManager::setDiurnalPeriod(int diurnalPeriod) {
+    this->diurnalPeriod = diurnalPeriod;
+}
+
+void ConsoleManager::setClosedLoopUsers(int closedLoopUsers) {
+    this->closedLoopUsers = closedLoopUsers;
+}
+
+void ConsoleManager::setThinkTicks(int thinkTicks) {
+    this->thinkTicks = thinkTicks;
+}
+
+void ConsoleManager::setSizeDistribution(const string& sizeDistribution) {
+    this->sizeDistribution = sizeDistribution;
+}
+
+void ConsoleManager::setSizeSigma(double sizeSigma) {
+    this->sizeSigma = sizeSigma;
+}
+
+void ConsoleManager::setSizeBimodalFraction(double sizeBimodalFraction) {
+    this->sizeBimodalFraction = sizeBimodalFraction;
+}
+
+void ConsoleManager::setCoreSpeeds(const std::vector<double>& coreSpeeds) {
+    this->coreSpeeds = coreSpeeds;
+}
+
+void ConsoleManager::setCapacityAware(bool capacityAware) {
+    this->capacityAware = capacityAware;
+}
+
+//Process Screen
+std::shared_ptr<Process> ConsoleManager::getScreenByProcessName(const std::string& processName) {
+    return ProcessRegistry::getInstance()->findProcess(processName);
 }
 
 shared_ptr<ProcessScreen> ConsoleManager::getCurrentConsole()
@@ -250,8 +603,9 @@ shared_ptr<ProcessScreen> ConsoleManager::getCurrentConsole()
     return this->currentConsole;
 }
 
-void ConsoleManager::registerConsole(shared_ptr<ProcessScreen> screenRef) {
-    this->screenMap[screenRef->getConsoleName()] = screenRef;
+// Returns false if a screen with the same name already exists
+bool ConsoleManager::registerConsole(shared_ptr<ProcessScreen> screenRef) {
+    return ProcessRegistry::getInstance()->add(screenRef);
 }
 
 void ConsoleManager::setCurrentConsole(shared_ptr<ProcessScreen> screenRef)
@@ -261,8 +615,9 @@ void ConsoleManager::setCurrentConsole(shared_ptr<ProcessScreen> screenRef)
 
 void ConsoleManager::switchConsole(string consoleName)
 {
-    if (this->screenMap.contains(consoleName)) {
-        this->currentConsole = this->screenMap[consoleName];
+    shared_ptr<ProcessScreen> screen = ProcessRegistry::getInstance()->find(consoleName);
+    if (screen) {
+        this->currentConsole = screen;
         this->consoleName = consoleName;
 
         if (consoleName == MAIN_CONSOLE) {
@@ -287,10 +642,13 @@ void ConsoleManager::setInitialized(bool initialized) {
 
 // Process information
 string ConsoleManager::getCurrentTimestamp() {
-    time_t currentTime = time(nullptr);
+    return formatTimestamp(time(nullptr));
+}
+
+string ConsoleManager::formatTimestamp(time_t timestamp) {
     tm localTime;
 
-	localtime_s(&localTime, &currentTime); // localtime_s for thread safety
+	localtime_s(&localTime, &timestamp); // localtime_s for thread safety
     
 	char timeBuffer[100]; // Buffer to store formatted time
     strftime(timeBuffer, sizeof(timeBuffer), "%m/%d/%Y, %I:%M:%S %p", &localTime);
@@ -316,43 +674,71 @@ int ConsoleManager::getNumPages() {
 }
 
 void ConsoleManager::setNumPages() {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(ConsoleManager::getInstance()->getMinMemPerProc(), ConsoleManager::getInstance()->getMaxMemPerProc());
+    int memory = Random::getInstance()->nextUniform(Random::PAGES, static_cast<int>(ConsoleManager::getInstance()->getMinMemPerProc()), static_cast<int>(ConsoleManager::getInstance()->getMaxMemPerProc()));
 
-    this->numPages = dis(gen) / ConsoleManager::getInstance()->getMemPerFrame();
+    this->numPages = memory / ConsoleManager::getInstance()->getMemPerFrame();
 }
 
 // Scheduler
 void ConsoleManager::schedulerTest() {
-    static int process_counter = 0;
-    process_counter++;
+    string unknown = !ArrivalGenerator::isKnownModel(arrivalModel) ? "arrival-model " + arrivalModel
+        : !ArrivalGenerator::isKnownDistribution(sizeDistribution) ? "size-distribution " + sizeDistribution : "";
+    if (!unknown.empty()) {
+        cout << ConsoleColor::RED << "Unknown " << unknown << ConsoleColor::RESET << endl;
+        Scheduler::getInstance()->setSchedulerTestRunning(false);
+        return;
+    }
+
+    // Modelled traffic, and batches in lockstep, come from timers on the sim clock; this thread
+    // only waits for scheduler-stop
+    if (arrivalModel != "batch" || ConsoleManager::getInstance()->getLockstep()) {
+        arrivalGenerator.start();
+        while (Scheduler::getInstance()->getSchedulerTestRunning()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        arrivalGenerator.stop();
+        return;
+    }
 
     while (Scheduler::getInstance()->getSchedulerTestRunning()) {
         for (int i = 0; i < ConsoleManager::getInstance()->getBatchProcessFrequency(); i++) {
-           /* string processName = "cycle" + std::to_string(ConsoleManager::getInstance()->cpuCycles) + "processName" + std::to_string(i);*/
-            string processName = "P" + std::to_string(process_counter);
-            shared_ptr<ProcessScreen> processScreen = make_shared<Process>(processName, 0, ConsoleManager::getInstance()->getCurrentTimestamp(), ConsoleManager::getInstance()->getMinMemPerProc());
-            shared_ptr<Process> processPtr = static_pointer_cast<Process>(processScreen);
-            Scheduler::getInstance()->addProcessToQueue(processPtr);
-            ConsoleManager::getInstance()->registerConsole(processScreen);
-            ConsoleManager::getInstance()->cpuCycles++;
-            
-
+            createTestProcess();
         }
-        process_counter++;
-
-		std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
     }
 }
 
+std::shared_ptr<Process> ConsoleManager::createTestProcess() {
+    // Names must be unique: the registry refuses a second process with the same name, so names
+    // taken by user screens (screen -s P7) are skipped, and only a registered process is queued
+    shared_ptr<Process> processPtr;
+    do {
+        string processName;
+        do {
+            processCounter++;
+            processName = "P" + std::to_string(processCounter);
+        } while (ProcessRegistry::getInstance()->contains(processName));
+        processPtr = makePooled<Process>(processName, 0, time(nullptr), ConsoleManager::getInstance()->getMinMemPerProc());
+    } while (!ConsoleManager::getInstance()->registerConsole(processPtr));
+
+    processPtr->setTotalLine(ArrivalGenerator::drawInstructions());
+    Scheduler::getInstance()->addProcessToQueue(processPtr);
+    ConsoleManager::getInstance()->cpuCycles++;
+    return processPtr;
+}
+
 bool ConsoleManager::isRunning() {
     return this->running;
 }
 
 //Printing
+// A core of -1 means the process is not on a core
+static string formatCore(int core) {
+    return core == -1 ? "N/A" : to_string(core);
+}
+
 void ConsoleManager::displayProcessList() {
-    unordered_map<string, shared_ptr<ProcessScreen>> screenMap = ConsoleManager::getInstance()->getScreenMap();
+    PROFILE_ZONE(RENDER);
     Scheduler* scheduler = Scheduler::getInstance();
     int coresUsed = scheduler->getCoresUsed();
     int coresAvailable = scheduler->getCoresAvailable();
@@ -363,79 +749,138 @@ void ConsoleManager::displayProcessList() {
     cout << "Cores available: " << coresAvailable << endl;
     cout << "-----------------------------------" << endl;
     cout << "Running processes:" << endl;
-    for (const auto& pair : screenMap) {
-        shared_ptr<Process> processPtr = dynamic_pointer_cast<Process>(pair.second);
+    ProcessTable* table = ProcessTable::getInstance();
+    for (int pid : table->getPidsInState(Process::RUNNING)) {
+        cout << table->name(pid) << "\t(" << formatTimestamp(table->created(pid)) << ")\tCore: " << table->core(pid) << "\tProgress: "
+            << table->currentLine(pid) << "/" << table->totalLine(pid) << endl;
+    }
 
-        if (processPtr && processPtr->getIsRunning() && processPtr->getMemoryUsage() != 0) {
+    cout << "\nFinished processes:" << endl;
+    ProcessHistory::getInstance()->forEach([this](const ProcessHistory::Record& record) {
+        cout << *record.name << "\t(" << formatTimestamp(record.created) << ")\tCore: " << "\tFinished"
+            << record.instructions << "/" << record.instructions << endl;
+        });
+    cout << "-----------------------------------" << endl;
+}
 
-            auto coreID = processPtr->getCPUCoreID();
-            string coreIDstr;
-            if (coreID == -1) {
-                coreIDstr = "N/A";
-            }
-            else {
-                coreIDstr = to_string(coreID);
-            }
+// One page of the processes in a state, sorted by pid, name, progress or arrival
+void ConsoleManager::displayProcessList(const string& stateName, const string& sortKey, int limit, int page) {
+    PROFILE_ZONE(RENDER);
+    static const string STATE_NAMES[ProcessTable::NUM_STATES] = { "ready", "running", "waiting", "finished", "swapped" };
 
-            cout << processPtr->getProcessName() << "\t(" << processPtr->getTimestamp() << ")\tCore: " << coreIDstr << "\tProgress: "
-        	<< processPtr->getCurrentLine() << "/" << processPtr->getTotalLine() << endl;
-        }
+    int state = static_cast<int>(std::find(std::begin(STATE_NAMES), std::end(STATE_NAMES), stateName) - std::begin(STATE_NAMES));
+    if (state == ProcessTable::NUM_STATES) {
+        cout << ConsoleColor::RED << "Unknown state: " << stateName << " (ready, running, waiting, swapped, finished)" << ConsoleColor::RESET << endl;
+        return;
     }
 
-    cout << "\nFinished processes:" << endl;
-    for (const auto& pair : screenMap) {
-        shared_ptr<Process> processPtr = dynamic_pointer_cast<Process>(pair.second);
+    ProcessTable* table = ProcessTable::getInstance();
+    std::function<bool(int, int)> compare;
+    if (sortKey == "pid") {
+        compare = [](int a, int b) { return a < b; };
+    }
+    else if (sortKey == "name") {
+        compare = [table](int a, int b) { return table->name(a) < table->name(b); };
+    }
+    else if (sortKey == "progress") {
+        // Furthest along first
+        compare = [table](int a, int b) {
+            return int64_t(table->currentLine(a)) * std::max(table->totalLine(b), 1) > int64_t(table->currentLine(b)) * std::max(table->totalLine(a), 1);
+            };
+    }
+    else if (sortKey == "arrival") {
+        compare = [table](int a, int b) { return table->created(a) != table->created(b) ? table->created(a) < table->created(b) : a < b; };
+    }
+    else {
+        cout << ConsoleColor::RED << "Unknown sort key: " << sortKey << " (pid, name, progress, arrival)" << ConsoleColor::RESET << endl;
+        return;
+    }
+
+    // Finished processes are archived and their table entries released, so they are listed from the history
+    if (state == Process::FINISHED) {
+        std::vector<const ProcessHistory::Record*> records;
+        ProcessHistory::getInstance()->forEach([&records](const ProcessHistory::Record& record) {
+            records.push_back(&record);
+            });
+
+        // Every finished process ran to completion, so progress falls back to pid order
+        std::function<bool(const ProcessHistory::Record*, const ProcessHistory::Record*)> compareRecords;
+        if (sortKey == "name") {
+            compareRecords = [](const ProcessHistory::Record* a, const ProcessHistory::Record* b) { return *a->name < *b->name; };
+        }
+        else if (sortKey == "arrival") {
+            compareRecords = [](const ProcessHistory::Record* a, const ProcessHistory::Record* b) { return a->created != b->created ? a->created < b->created : a->pid < b->pid; };
+        }
+        else {
+            compareRecords = [](const ProcessHistory::Record* a, const ProcessHistory::Record* b) { return a->pid < b->pid; };
+        }
 
+        size_t first = std::min(records.size(), static_cast<size_t>(std::max(page - 1, 0)) * std::max(limit, 0));
+        size_t last = std::min(records.size(), first + std::max(limit, 0));
+        std::partial_sort(records.begin(), records.begin() + last, records.end(), compareRecords);
 
-        if (processPtr && processPtr->isFinished()) {
-            cout << processPtr->getProcessName() << "\t(" << processPtr->getTimestamp() << ")\tCore: " << "\tFinished"
-                << processPtr->getCurrentLine() << "/" << processPtr->getTotalLine() << endl;
+        cout << "Showing " << (last > first ? first + 1 : 0) << "-" << last << " of " << records.size() << " " << stateName << " processes" << endl;
+        for (size_t i = first; i < last; i++) {
+            const ProcessHistory::Record& record = *records[i];
+            cout << *record.name << "\t(" << formatTimestamp(record.created) << ")\tCore: " << formatCore(record.core) << "\tProgress: "
+                << record.instructions << "/" << record.instructions << endl;
         }
+        return;
+    }
+
+    // Only the requested page needs to be in order
+    std::vector<int> pids = table->getPidsInState(static_cast<uint8_t>(state));
+    size_t first = std::min(pids.size(), static_cast<size_t>(std::max(page - 1, 0)) * std::max(limit, 0));
+    size_t last = std::min(pids.size(), first + std::max(limit, 0));
+    std::partial_sort(pids.begin(), pids.begin() + last, pids.end(), compare);
+
+    cout << "Showing " << (last > first ? first + 1 : 0) << "-" << last << " of " << pids.size() << " " << stateName << " processes" << endl;
+    for (size_t i = first; i < last; i++) {
+        int pid = pids[i];
+        cout << table->name(pid) << "\t(" << formatTimestamp(table->created(pid)) << ")\tCore: " << formatCore(table->core(pid)) << "\tProgress: "
+            << table->currentLine(pid) << "/" << table->totalLine(pid) << endl;
     }
-    cout << "-----------------------------------" << endl;
 }
 
 void ConsoleManager::printProcess(string enteredProcess){
-    unordered_map<string, shared_ptr<ProcessScreen>> screenMap = ConsoleManager::getInstance()->getScreenMap();
-    auto it = screenMap.find(enteredProcess);
-    for (const auto& pair : screenMap) {
-        shared_ptr<Process> processPtr = dynamic_pointer_cast<Process>(pair.second);
-
-        //check if process name exits
-        if (processPtr->getProcessName() == enteredProcess) {
-
-            //check if process is finished
-            if (processPtr && processPtr->isFinished()){
-                shared_ptr<Process> processPtr = dynamic_pointer_cast<Process>(screenMap.find(enteredProcess)->second);
-
-                auto coreID = processPtr->getCPUCoreID();
-                string coreIDstr;
-                if (coreID == -1) {
-                    coreIDstr = "N/A";
-                }
-                else {
-                    coreIDstr = to_string(coreID);
-                }
-
-                cout << "Process Name: " << enteredProcess << endl;
-                cout << "Logs:" << endl;
-                cout << "(" << processPtr->getTimestamp() << ")  "
-                    << "Core: " << coreIDstr << "  ";
+    shared_ptr<Process> processPtr = ProcessRegistry::getInstance()->findProcess(enteredProcess);
+    if (processPtr && !processPtr->isFinished()) {
+        cout << ConsoleColor::YELLOW << "Process is not yet finished" << ConsoleColor::RESET << endl;
+        return;
+    }
 
-                processPtr->createFile();
-                processPtr->viewFile();
-            }
-            else {
-                cout << ConsoleColor::YELLOW << "Process is not yet finished" << ConsoleColor::RESET << endl;
+    // A finished process leaves the registry once it is archived, so fall back to its latest history record
+    string timestamp;
+    int coreID = -1;
+    if (processPtr) {
+        timestamp = processPtr->getTimestamp();
+        coreID = processPtr->getCPUCoreID();
+    }
+    else {
+        const ProcessHistory::Record* found = nullptr;
+        ProcessHistory::getInstance()->forEach([&found, &enteredProcess](const ProcessHistory::Record& record) {
+            if (*record.name == enteredProcess) {
+                found = &record;
             }
-            
+            });
+        if (!found) {
+            cout << ConsoleColor::YELLOW << "Process " << enteredProcess << " not found." << ConsoleColor::RESET << endl;
+            return;
         }
-
+        timestamp = formatTimestamp(found->created);
+        coreID = found->core;
     }
+
+    cout << "Process Name: " << enteredProcess << endl;
+    cout << "Logs:" << endl;
+    cout << "(" << timestamp << ")  "
+        << "Core: " << formatCore(coreID) << "  ";
+
+    Process::createFile(enteredProcess);
+    Process::viewFile(enteredProcess);
 }
 
 void ConsoleManager::printProcessSmi() {
-    unordered_map<string, shared_ptr<ProcessScreen>> screenMap = ConsoleManager::getInstance()->getScreenMap();
     Scheduler* scheduler = Scheduler::getInstance();
     int coresUsed = scheduler->getCoresUsed();
     int coresAvailable = scheduler->getCoresAvailable();
@@ -451,18 +896,18 @@ void ConsoleManager::printProcessSmi() {
     cout << "Running processes and memory usage:" << endl;
     cout << "---------------------------------------------------" << endl;
 
-    // Iterate through screenMap to get running processes and their memory usage
-    for (const auto& pair : screenMap) {
-        auto processPtr = std::dynamic_pointer_cast<Process>(pair.second);
-        if (processPtr && !processPtr->isFinished() && processPtr->getIsRunning() && processPtr->getMemoryUsage() != 0) {  
-            size_t memoryUsage = processPtr->getMemoryUsage();
-            cout << "Process: " << processPtr->getProcessName() << " | Memory: " << memoryUsage << " KB" << endl;
+    // Walk the running list to get running processes and their memory usage
+    ProcessTable* table = ProcessTable::getInstance();
+    for (int pid : table->getPidsInState(Process::RUNNING)) {
+        if (table->memoryUsage(pid) != 0) {
+            cout << "Process: " << table->name(pid) << " | Memory: " << table->memoryUsage(pid) << " KB" << endl;
         }
     }
 	cout << "===================================================" << endl << endl;
 }
 
 void ConsoleManager::printVmstat() {
+    PROFILE_ZONE(REPORT);
     cout << ConsoleColor::BLUE << ConsoleManager::getInstance()->getMaxOverallMem() << ConsoleColor::RESET << " KB" << " total memory" << endl;
     if (ConsoleManager::getInstance()->getMinMemPerProc() == ConsoleManager::getInstance()->getMaxMemPerProc()) {
         cout << ConsoleColor::BLUE << FlatMemoryAllocator::getInstance()->getTotalMemoryUsage() << ConsoleColor::RESET << " KB" << " used memory" << endl;
@@ -473,15 +918,55 @@ void ConsoleManager::printVmstat() {
         cout << ConsoleColor::BLUE << ConsoleManager::getInstance()->getMaxOverallMem() - PagingAllocator::getInstance()->getUsedMemory() << ConsoleColor::RESET << " KB" << " free memory" << endl;
     }
     cout << ConsoleColor::BLUE << Scheduler::getInstance()->getIdleCpuTicks() << ConsoleColor::RESET << " idle cpu ticks" << endl;
-    cout << ConsoleColor::BLUE << Scheduler::getInstance()->getCpuCycles() << ConsoleColor::RESET << " active cpu ticks" << endl;
-    cout << ConsoleColor::BLUE << Scheduler::getInstance()->getCpuCycles() + Scheduler::getInstance()->getIdleCpuTicks() << ConsoleColor::RESET << " total cpu ticks" << endl;
+    cout << ConsoleColor::BLUE << Scheduler::getInstance()->getBusyCpuTicks() << ConsoleColor::RESET << " active cpu ticks" << endl;
+    cout << ConsoleColor::BLUE << Scheduler::getInstance()->getBusyCpuTicks() + Scheduler::getInstance()->getIdleCpuTicks() << ConsoleColor::RESET << " total cpu ticks" << endl;
+    cout << ConsoleColor::BLUE << Scheduler::getInstance()->getCpuCycles() << ConsoleColor::RESET << " instructions executed" << endl;
+    cout << ConsoleColor::BLUE << Scheduler::getInstance()->getNumFaulted() << ConsoleColor::RESET << " processes faulted" << endl;
+    cout << ConsoleColor::BLUE << Scheduler::getInstance()->getNumWaitingForIo() << ConsoleColor::RESET << " processes waiting for I/O" << endl;
+    cout << ConsoleColor::BLUE << Scheduler::getInstance()->getNumIoCompleted() << ConsoleColor::RESET << " I/O requests completed" << endl;
+    cout << ConsoleColor::BLUE << TimerWheel::getInstance()->getCurrentTick() << ConsoleColor::RESET << " sim ticks" << endl;
+    cout << ConsoleColor::BLUE << TimerWheel::getInstance()->getNumScheduled() << ConsoleColor::RESET << " pending timers" << endl;
+    cout << ConsoleColor::BLUE << Telemetry::getInstance()->getNumRecorded() << ConsoleColor::RESET << " telemetry samples recorded" << endl;
+    cout << ConsoleColor::BLUE << ObjectPool::getInstance()->getNumLive() << ConsoleColor::RESET << " pooled objects live" << endl;
+    cout << ConsoleColor::BLUE << ObjectPool::getInstance()->getNumChunks() << ConsoleColor::RESET << " pool chunks allocated" << endl;
     cout << ConsoleColor::BLUE << PagingAllocator::getInstance()->getNumPagedIn() << ConsoleColor::RESET << " num paged in" << endl;
-    cout << ConsoleColor::BLUE << PagingAllocator::getInstance()->getNumPagedOut() << ConsoleColor::RESET << " num paged out"<< endl << endl;
+    cout << ConsoleColor::BLUE << PagingAllocator::getInstance()->getNumPagedOut() << ConsoleColor::RESET << " num paged out"<< endl;
+    cout << ConsoleColor::BLUE << PagingAllocator::getInstance()->getNumSharedFrames() << ConsoleColor::RESET << " shared frames" << endl;
+    cout << ConsoleColor::BLUE << PagingAllocator::getInstance()->getNumSharingPages() << ConsoleColor::RESET << " pages sharing" << endl;
+    cout << ConsoleColor::BLUE << PagingAllocator::getInstance()->getNumCopyOnWrite() << ConsoleColor::RESET << " copy-on-write faults" << endl;
+    cout << ConsoleColor::BLUE << PagingAllocator::getInstance()->getNumPageFaults() << ConsoleColor::RESET << " page faults without a free frame" << endl;
+    cout << ConsoleColor::BLUE << PagingAllocator::getInstance()->getMemorySavedByMerging() << ConsoleColor::RESET << " KB saved by page merging" << endl;
+    cout << ConsoleColor::BLUE << PagingAllocator::getInstance()->getPageTableMemory() << ConsoleColor::RESET << " bytes of page tables" << endl;
+    SwapPool::getInstance()->printStats();
+    cout << endl;
+    Scheduler::printCoreUsage(cout, Scheduler::getInstance()->getCoreUsage(), Scheduler::getInstance()->getElapsedTicks());
+    cout << endl;
+}
+
+// Print one line of system state every intervalTicks sim ticks, like vmstat <delay> <count>
+void ConsoleManager::printVmstatInterval(int intervalTicks, int count) {
+    cout << ConsoleColor::BLUE << setw(8) << "tick" << setw(7) << "cpu%" << setw(6) << "busy" << setw(7) << "queue" << setw(5) << "io"
+        << setw(10) << "mem-used" << setw(13) << "frames-free" << setw(8) << "pg-in" << setw(8) << "pg-out" << ConsoleColor::RESET << endl;
+
+    Telemetry::Sample previous = Telemetry::getInstance()->sample();
+    for (int i = 0; i < count; i++) {
+        if (!TimerWheel::getInstance()->waitTicks(intervalTicks)) {
+            break;
+        }
+
+        Telemetry::Sample current = Telemetry::getInstance()->sample();
+        cout << setw(8) << current.tick << setw(7) << fixed << setprecision(1) << Telemetry::getCpuUtilization(previous, current)
+            << setw(6) << current.coresBusy << setw(7) << current.queueLength << setw(5) << current.waitingForIo
+            << setw(10) << current.memoryUsed << setw(13) << current.framesFree
+            << setw(8) << current.pagedIn << setw(8) << current.pagedOut << defaultfloat << endl;
+        previous = current;
+    }
+    cout << endl;
 }
 
 void ConsoleManager::reportUtil() {
+    PROFILE_ZONE(REPORT);
     std::ostringstream logStream;
-    unordered_map<string, shared_ptr<ProcessScreen>> screenMap = ConsoleManager::getInstance()->getScreenMap();
     Scheduler* scheduler = Scheduler::getInstance();
     int coresUsed = scheduler->getCoresUsed();
     int coresAvailable = scheduler->getCoresAvailable();
@@ -492,38 +977,25 @@ void ConsoleManager::reportUtil() {
     logStream << "Cores used: " << coresUsed << std::endl;
     logStream << "Cores available: " << coresAvailable << std::endl;
     logStream << "-----------------------------------" << std::endl;
+    Scheduler::printCoreUsage(logStream, scheduler->getCoreUsage(), scheduler->getElapsedTicks());
+    logStream << "-----------------------------------" << std::endl;
     logStream << "Running processes:" << std::endl;
 
-    for (const auto& pair : screenMap) {
-        shared_ptr<Process> processPtr = dynamic_pointer_cast<Process>(pair.second);
-
-        if (processPtr && processPtr->getIsRunning() && processPtr->getMemoryUsage() != 0) {
-
-            auto coreID = processPtr->getCPUCoreID();
-            string coreIDstr;
-            if (coreID == -1) {
-                coreIDstr = "N/A";
-            }
-            else {
-                coreIDstr = to_string(coreID);
-            }
-
-            logStream << processPtr->getProcessName() << "\t(" << processPtr->getTimestamp() << ")\tCore: " << coreIDstr << "\tProgress: "
-                << processPtr->getCurrentLine() << "/" << processPtr->getTotalLine() << endl;
-        }
+    ProcessTable* table = ProcessTable::getInstance();
+    for (int pid : table->getPidsInState(Process::RUNNING)) {
+        logStream << table->name(pid) << "\t(" << formatTimestamp(table->created(pid)) << ")\tCore: " << table->core(pid) << "\tProgress: "
+            << table->currentLine(pid) << "/" << table->totalLine(pid) << endl;
     }
 
     logStream << "\nFinished processes:" << endl;
-    for (const auto& pair : screenMap) {
-        shared_ptr<Process> processPtr = dynamic_pointer_cast<Process>(pair.second);
-
-        if (processPtr && processPtr->isFinished()) {
-            logStream << processPtr->getProcessName() << "\t(" << processPtr->getTimestamp() << ")\tCore: " << "\tFinished"
-                << processPtr->getCurrentLine() << "/" << processPtr->getTotalLine() << endl;
-        }
-    }
+    ProcessHistory::getInstance()->forEach([this, &logStream](const ProcessHistory::Record& record) {
+        logStream << *record.name << "\t(" << formatTimestamp(record.created) << ")\tCore: " << "\tFinished"
+            << record.instructions << "/" << record.instructions << endl;
+        });
 
     logStream << "-----------------------------------" << std::endl;
+    LatencyStats::getInstance()->printReport(logStream);
+    logStream << "-----------------------------------" << std::endl;
 
     // Write the log data to a file
     std::ofstream file("csopesy-log.txt", std::ios::out);
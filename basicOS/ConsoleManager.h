@@ -4,10 +4,13 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
+#include <utility>
 
 #include "Process.h"
 #include "ConsoleColor.h"
 #include "Scheduler.h"
+#include "ArrivalGenerator.h"
 
 const string MAIN_CONSOLE = "MAIN_CONSOLE";
 
@@ -26,7 +29,7 @@ public:
 
 	static ConsoleManager* getInstance();
 
-	static void initialize();
+	static void initialize(bool loadConfiguration = true);
 
 	void drawConsole();
 	void printHeader();
@@ -34,7 +37,8 @@ public:
 	void exitApplication();
 
 	// Configuration getters and setters
-	void initializeConfiguration();
+	void initializeConfiguration(const std::vector<std::pair<string, string>>& overrides = {});
+	bool setConfiguration(const string& key, string value);
 	void initializeAllocators();
 
 	// getters
@@ -49,6 +53,34 @@ public:
 	size_t getMemPerFrame();
 	size_t getMinMemPerProc();
 	size_t getMaxMemPerProc();
+	int getPageMergeInterval();
+	int getPageTableLevels();
+	size_t getVirtualMemPerProc();
+	size_t getSwapPoolSize();
+	string getSwapDirectory();
+	int getIoFrequency();
+	int getIoLatency();
+	int getNumIoDevices();
+	int getTickDuration();
+	int getSnapshotInterval();
+	int getExecutorThreads();
+	int getTelemetryInterval();
+	size_t getTelemetryCapacity();
+	size_t getTraceBufferEvents();
+	uint64_t getSeed();
+	bool getLockstep();
+	string getArrivalModel();
+	double getArrivalRate();
+	int getBurstOnTicks();
+	int getBurstOffTicks();
+	int getDiurnalPeriod();
+	int getClosedLoopUsers();
+	int getThinkTicks();
+	string getSizeDistribution();
+	double getSizeSigma();
+	double getSizeBimodalFraction();
+	std::vector<double> getCoreSpeeds();
+	bool getCapacityAware();
 
 	//setters
 	void setNumCpu(int num_cpu);
@@ -62,12 +94,39 @@ public:
 	void setMemPerFrame(size_t memPerFrame);
 	void setMinMemPerProc(size_t minMemPerProc);
 	void setMaxMemPerProc(size_t maxMemPerProc);
+	void setPageMergeInterval(int pageMergeInterval);
+	void setPageTableLevels(int pageTableLevels);
+	void setVirtualMemPerProc(size_t virtualMemPerProc);
+	void setSwapPoolSize(size_t swapPoolSize);
+	void setSwapDirectory(const string& swapDirectory);
+	void setIoFrequency(int ioFrequency);
+	void setIoLatency(int ioLatency);
+	void setNumIoDevices(int numIoDevices);
+	void setTickDuration(int tickDuration);
+	void setSnapshotInterval(int snapshotInterval);
+	void setExecutorThreads(int executorThreads);
+	void setTelemetryInterval(int telemetryInterval);
+	void setTelemetryCapacity(size_t telemetryCapacity);
+	void setTraceBufferEvents(size_t traceBufferEvents);
+	void setSeed(uint64_t seed);
+	void setLockstep(bool lockstep);
+	void setArrivalModel(const string& arrivalModel);
+	void setArrivalRate(double arrivalRate);
+	void setBurstOnTicks(int burstOnTicks);
+	void setBurstOffTicks(int burstOffTicks);
+	void setDiurnalPeriod(int diurnalPeriod);
+	void setClosedLoopUsers(int closedLoopUsers);
+	void setThinkTicks(int thinkTicks);
+	void setSizeDistribution(const string& sizeDistribution);
+	void setSizeSigma(double sizeSigma);
+	void setSizeBimodalFraction(double sizeBimodalFraction);
+	void setCoreSpeeds(const std::vector<double>& coreSpeeds);
+	void setCapacityAware(bool capacityAware);
 
 	//Process Screen
 	std::shared_ptr<Process> getScreenByProcessName(const std::string& processName);
-	std::unordered_map<string, std::shared_ptr<ProcessScreen>> getScreenMap();
 	std::shared_ptr<ProcessScreen> getCurrentConsole();
-	void registerConsole(std::shared_ptr<ProcessScreen> screenRef);
+	bool registerConsole(std::shared_ptr<ProcessScreen> screenRef);
 	void setCurrentConsole(std::shared_ptr<ProcessScreen> screenRef);
 	void switchConsole(string consoleName);
 	bool getInitialized();
@@ -75,6 +134,7 @@ public:
 
 	// Process information
 	string getCurrentTimestamp();
+	string formatTimestamp(time_t timestamp);
 	int getCpuCycles();
 	void getMemoryUsage();
 	int getNumPages();
@@ -82,14 +142,17 @@ public:
 
 	// Scheduler
 	void schedulerTest();
+	std::shared_ptr<Process> createTestProcess();
 	bool isRunning();
 	
 	//Printing
 	void displayProcessList();
+	void displayProcessList(const string& stateName, const string& sortKey, int limit, int page);
 	void printProcess(string enteredProcess);\
 	void printProcessSmi();
 	void reportUtil();
 	void printVmstat();
+	void printVmstatInterval(int intervalTicks, int count);
 
 private:
 	static ConsoleManager* consoleManager;
@@ -110,10 +173,40 @@ private:
 	size_t minMemPerProc = 0;
 	size_t maxMemPerProc = 0;
 	size_t numPages = 0;
+	int pageMergeInterval = 0;
+	int pageTableLevels = 1;
+	size_t virtualMemPerProc = 0;
+	size_t swapPoolSize = 0;
+	string swapDirectory = "backing-store";
+	int ioFrequency = 0;
+	int ioLatency = 0;
+	int numIoDevices = 1;
+	int tickDuration = 100;
+	int snapshotInterval = 0;
+	int executorThreads = 0;
+	int telemetryInterval = 1;
+	size_t telemetryCapacity = 4096;
+	size_t traceBufferEvents = 16384;
+	uint64_t seed = 0;	// 0 draws a fresh seed every run
+	bool lockstep = false;
+	string arrivalModel = "batch";
+	double arrivalRate = 100;	// Processes per 1000 ticks
+	int burstOnTicks = 500;
+	int burstOffTicks = 1500;
+	int diurnalPeriod = 10000;
+	int closedLoopUsers = 8;
+	int thinkTicks = 200;
+	string sizeDistribution = "uniform";
+	double sizeSigma = 1.0;
+	double sizeBimodalFraction = 0.8;
+	std::vector<double> coreSpeeds = { 1.0 };	// Instructions per tick, the last one repeating
+	bool capacityAware = true;
+	int processCounter = 0;
+
+	ArrivalGenerator arrivalGenerator;
  
 	Scheduler scheduler;
 
 	std::shared_ptr<ProcessScreen> currentConsole;
 	std::stringstream logStream;
-	std::unordered_map<string, std::shared_ptr<ProcessScreen>> screenMap;
 };
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <iomanip>
+#include <thread>
+
+#include "EventTrace.h"
+#include "Machine.h"
+#include "ProcessTable.h"
+#include "TimerWheel.h"
+
+using namespace std;
+
+static uint64_t hostNanoseconds() {
+	return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Process names are user input, so quotes and backslashes are escaped for JSON
+static string jsonString(const string& text) {
+	string escaped = "\"";
+	for (char c : text) {
+		if (c == '"' || c == '\\') {
+			escaped += '\\';
+		}
+		if (static_cast<unsigned char>(c) >= 0x20) {
+			escaped += c;
+		}
+	}
+	return escaped + "\"";
+}
+
+EventTrace* EventTrace::eventTrace = nullptr;
+
+EventTrace* EventTrace::getInstance() {
+	EventTrace*& instance = Machine::slot(&Machine::eventTrace, eventTrace);
+	if (instance == nullptr) {
+		instance = new EventTrace();
+	}
+	return instance;
+}
+
+// Clear the previous trace and keep the latest eventsPerCore events of every core
+void EventTrace::start(int numCores, size_t eventsPerCore) {
+	if (enabled) {
+		return;
+	}
+	quiesce();
+
+	if (numRings != numCores || (numRings > 0 && rings[0].capacity != eventsPerCore)) {
+		rings = std::make_unique<CoreRing[]>(numCores);
+		numRings = numCores;
+		for (int core = 0; core < numRings; core++) {
+			rings[core].events = std::make_unique_for_overwrite<Event[]>(eventsPerCore); // Pages are touched only as events arrive
+			rings[core].capacity = eventsPerCore;
+		}
+	}
+	for (int core = 0; core < numRings; core++) {
+		rings[core].head = 0;
+	}
+
+	startNs = hostNanoseconds();
+	enabled.store(true, std::memory_order_release);
+}
+
+void EventTrace::stop() {
+	quiesce();
+}
+
+// Turn recording off and wait out appends that saw it on, so the rings can be reset or read
+void EventTrace::quiesce() {
+	enabled.store(false);
+	while (numAppending.load() != 0) {
+		std::this_thread::yield();
+	}
+}
+
+// An append counts itself in before checking enabled again, so quiesce() either sees it or it sees quiesce()
+void EventTrace::append(int core, EventType type, int pid) {
+	numAppending.fetch_add(1);
+	if (enabled.load() && core >= 0 && core < numRings) {
+		CoreRing& ring = rings[core];
+		size_t head = ring.head.load(std::memory_order_relaxed);
+
+		Event& event = ring.events[head % ring.capacity];
+		event.hostNs = hostNanoseconds() - startNs;
+		event.tick = TimerWheel::getInstance()->getCurrentTick();
+		event.name = &ProcessTable::getInstance()->name(pid);
+		event.pid = pid;
+		event.type = type;
+		ring.head.store(head + 1, std::memory_order_release);
+	}
+	numAppending.fetch_sub(1, std::memory_order_release);
+}
+
+// Events held in the ring, oldest first; recording must be quiesced
+std::vector<EventTrace::Event> EventTrace::snapshot(const CoreRing& ring) const {
+	size_t head = ring.head.load(std::memory_order_acquire);
+	size_t first = head > ring.capacity ? head - ring.capacity : 0;
+
+	std::vector<Event> events;
+	events.reserve(head - first);
+	for (size_t i = first; i < head; i++) {
+		events.push_back(ring.events[i % ring.capacity]);
+	}
+	return events;
+}
+
+// Events held in the rings, at most eventsPerCore per core
+size_t EventTrace::getNumEvents() const {
+	size_t numEvents = 0;
+	for (int core = 0; core < numRings; core++) {
+		numEvents += std::min(rings[core].head.load(std::memory_order_acquire), rings[core].capacity);
+	}
+	return numEvents;
+}
+
+// Oldest events a full ring wrote over
+size_t EventTrace::getNumOverwritten() const {
+	size_t numOverwritten = 0;
+	for (int core = 0; core < numRings; core++) {
+		size_t head = rings[core].head.load(std::memory_order_acquire);
+		numOverwritten += head - std::min(head, rings[core].capacity);
+	}
+	return numOverwritten;
+}
+
+// Write the trace as Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev).
+// Each core is a thread; a dispatch and the event that takes the process off the core
+// become one slice, and allocation failures and swaps are instant events.
+bool EventTrace::dump(const std::string& fileName) {
+	std::ofstream file(fileName, std::ios::out | std::ios::trunc);
+	if (!file) {
+		return false;
+	}
+
+	// Copy the rings with recording paused, then write the file while tracing continues
+	bool wasEnabled = isEnabled();
+	quiesce();
+	std::vector<std::vector<Event>> coreEvents;
+	for (int core = 0; core < numRings; core++) {
+		coreEvents.push_back(snapshot(rings[core]));
+	}
+	double nowUs = (hostNanoseconds() - startNs) / 1000.0;
+	if (wasEnabled) {
+		enabled.store(true, std::memory_order_release);
+	}
+
+	const char* endReasons[] = { "", "preempt", "io", "sleep", "finish" };
+	const char* instantNames[] = { "alloc fail", "swap out", "swap in" };
+	bool first = true;
+
+	auto separator = [&file, &first]() -> std::ofstream& {
+		file << (first ? "\n" : ",\n");
+		first = false;
+		return file;
+	};
+
+	// Timestamps are microseconds; keep nanosecond resolution instead of six significant digits
+	file << std::fixed << std::setprecision(3);
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	for (int core = 0; core < static_cast<int>(coreEvents.size()); core++) {
+		separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << core
+			<< ",\"args\":{\"name\":\"Core " << core << "\"}}";
+
+		// A slice whose dispatch was overwritten has no start and is left out
+		const Event* open = nullptr;
+		for (const Event& event : coreEvents[core]) {
+			double ts = event.hostNs / 1000.0;
+
+			switch (event.type) {
+			case DISPATCH:
+				open = &event;
+				break;
+
+			case PREEMPT:
+			case BLOCK:
+			case SLEEP:
+			case FINISH:
+				if (open && open->pid == event.pid) {
+					separator() << "{\"name\":" << jsonString(*event.name) << ",\"cat\":\"process\",\"ph\":\"X\",\"ts\":" << open->hostNs / 1000.0
+						<< ",\"dur\":" << ts - open->hostNs / 1000.0 << ",\"pid\":1,\"tid\":" << core
+						<< ",\"args\":{\"pid\":" << event.pid << ",\"start_tick\":" << open->tick << ",\"end_tick\":" << event.tick
+						<< ",\"end\":\"" << endReasons[event.type] << "\"}}";
+				}
+				open = nullptr;
+				break;
+
+			default:
+				separator() << "{\"name\":\"" << instantNames[event.type - ALLOC_FAIL] << "\",\"cat\":\"memory\",\"ph\":\"i\",\"s\":\"t\",\"ts\":" << ts
+					<< ",\"pid\":1,\"tid\":" << core << ",\"args\":{\"pid\":" << event.pid << ",\"process\":" << jsonString(*event.name)
+					<< ",\"tick\":" << event.tick << "}}";
+				break;
+			}
+		}
+
+		// A process still on the core runs until the dump
+		if (open) {
+			separator() << "{\"name\":" << jsonString(*open->name) << ",\"cat\":\"process\",\"ph\":\"X\",\"ts\":" << open->hostNs / 1000.0
+				<< ",\"dur\":" << std::max(0.0, nowUs - open->hostNs / 1000.0) << ",\"pid\":1,\"tid\":" << core
+				<< ",\"args\":{\"pid\":" << open->pid << ",\"start_tick\":" << open->tick << ",\"end\":\"running\"}}";
+		}
+	}
+	file << "\n]}\n";
+	return static_cast<bool>(file);
+}
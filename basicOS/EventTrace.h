@@ -0,0 +1,73 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Per-core log of scheduling events for a Gantt view of the simulated cores.
+// A core's ring is only written by the executor thread that owns the core, so recording
+// is a plain store plus a release of the head index. A full ring overwrites its oldest
+// events, so a trace always ends at the most recent ones. Starting, stopping and dumping
+// wait for in-flight appends to finish; a dump pauses recording while it copies the rings.
+class EventTrace
+{
+public:
+	enum EventType : uint8_t
+	{
+		DISPATCH,
+		PREEMPT,
+		BLOCK,		// Left the core for an I/O request
+		SLEEP,
+		FINISH,
+		ALLOC_FAIL,
+		SWAP_OUT,
+		SWAP_IN
+	};
+
+	struct Event
+	{
+		uint64_t hostNs;	// Host steady clock, relative to trace start
+		uint64_t tick;		// Sim clock
+		const std::string* name;	// Interned by the ProcessTable; the PID may be reused by the dump
+		int32_t pid;
+		EventType type;
+	};
+
+	static EventTrace* getInstance();
+
+	void start(int numCores, size_t eventsPerCore);
+	void stop();
+	bool isEnabled() const { return enabled.load(std::memory_order_acquire); }
+
+	// Costs one load while tracing is off
+	void record(int core, EventType type, int pid) {
+		if (isEnabled()) {
+			append(core, type, pid);
+		}
+	}
+
+	bool dump(const std::string& fileName);
+	size_t getNumEvents() const;
+	size_t getNumOverwritten() const;
+
+private:
+	struct CoreRing
+	{
+		std::unique_ptr<Event[]> events;
+		size_t capacity = 0;
+		std::atomic<size_t> head = 0;	// Events ever appended; the next one goes to head % capacity
+	};
+
+	void append(int core, EventType type, int pid);
+	void quiesce();
+	std::vector<Event> snapshot(const CoreRing& ring) const;
+
+	static EventTrace* eventTrace;
+	std::unique_ptr<CoreRing[]> rings;
+	int numRings = 0;
+	uint64_t startNs = 0;
+	std::atomic<bool> enabled = false;
+	std::atomic<int> numAppending = 0;
+};
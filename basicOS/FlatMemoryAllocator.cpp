@@ -3,6 +3,11 @@
 
 #include "FlatMemoryAllocator.h"
 #include "ConsoleManager.h"
+#include "SwapPool.h"
+#include "ProcessTable.h"
+#include "ProcessRegistry.h"
+#include "Profiler.h"
+#include "Machine.h"
 
 using namespace std;
 
@@ -25,31 +30,39 @@ FlatMemoryAllocator* FlatMemoryAllocator::flatMemoryAllocator = nullptr;
 
 // Initialize the memory allocator with the maximum size
 void FlatMemoryAllocator::initialize(size_t maximumMemorySize) {
-	flatMemoryAllocator = new FlatMemoryAllocator(maximumMemorySize);
+	Machine::slot(&Machine::flatMemoryAllocator, flatMemoryAllocator) = new FlatMemoryAllocator(maximumMemorySize);
 }
 
 // Get the static instance of the FlatMemoryAllocator
 FlatMemoryAllocator* FlatMemoryAllocator::getInstance() {
-	return flatMemoryAllocator;
+	return Machine::slot(&Machine::flatMemoryAllocator, flatMemoryAllocator);
 }
 
-// Mutex for protecting allocationMap
-std::mutex allocationMapMutex;
-
 // Allocate memory for a process
-void* FlatMemoryAllocator::allocate(size_t size, string processName, std::shared_ptr<Process> process) {
+void* FlatMemoryAllocator::allocate(size_t size, int pid, std::shared_ptr<Process> process) {
+	PROFILE_ZONE(FLAT_ALLOCATE);
 	{
 		std::lock_guard<std::mutex> lock(allocationMapMutex);  // Ensure thread safety	
 
 		// Check for the availability of a suitable block
 		for (size_t i = 0; i < maximumSize - size + 1; ++i) {
 			// Check if the memory block is available
-			if (allocationMap.find(i) == allocationMap.end() || allocationMap[i].empty()) {
+			if (allocationMap[i] == ProcessTable::NO_PID) {
 				if (canAllocateAt(i, size)) {
 					// Ensure that the requested block doesn't go out of bounds
-					allocateAt(i, size, processName);
-					process->setMemoryUsage(FlatMemoryAllocator::getInstance()->getProcessMemoryUsage(processName));
+					allocateAt(i, size, pid);
+
+					// Bring back the contents of a process that was swapped out
+					if (SwapPool::getInstance()->contains(pid)) {
+						SwapPool::getInstance()->swapIn(pid, &memory[i], size);
+						std::erase_if(backingStore, [pid](const std::shared_ptr<Process>& stored) {
+							return stored->getPid() == pid;
+							});
+					}
+
+					process->setMemoryUsage(FlatMemoryAllocator::getInstance()->getProcessMemoryUsage(pid));
 					process->setIsRunning(true);
+					process->setMemoryPtr(&memory[i]);
 					return &memory[i];  // Return pointer to allocated memory
 
 				}
@@ -60,57 +73,89 @@ void* FlatMemoryAllocator::allocate(size_t size, string processName, std::shared
 	return nullptr;  // Return nullptr if allocation fails
 }
 
-// Add a process to the backing store
+// Add a process to the backing store; call before deallocating so its memory image can be saved
 void FlatMemoryAllocator::allocateFromBackingStore(std::shared_ptr<Process> process) {
-	backingStore.push_back(process);
-}
+	PROFILE_ZONE(BACKING_STORE);
+	{
+		std::lock_guard<std::mutex> lock(allocationMapMutex);
+		size_t size = process->getMemoryRequired();
 
-// Find the oldest process in memory
-std::shared_ptr<Process> FlatMemoryAllocator::findOldestProcess() {
-	if (!allocationMap.empty()) {
-		size_t oldestIndex = maximumSize; // Start with the highest possible index
-		std::string oldestProcessName;
+		for (size_t i = 0; i + size <= maximumSize; ++i) {
+			if (allocationMap[i] == process->getPid()) {
+				SwapPool::getInstance()->swapOut(process->getPid(), &memory[i], size, ConsoleManager::getInstance()->getMemPerFrame());
+				break;
+			}
+		}
+		backingStore.push_back(process);
+	}
+	process->setStateIf(Process::READY, Process::SWAPPED);
+}
 
-		// Iterate through the allocationMap to find the smallest key with a valid process name
-		for (const auto& entry : allocationMap) {
-			size_t index = entry.first;
-			const std::string& processName = entry.second;
+// Move the oldest process in memory that is not running to the backing store.
+// Returns the PID of the swapped-out process, or NO_PID if every resident process is running.
+int FlatMemoryAllocator::swapOutOldest(int exceptPid) {
+	std::shared_ptr<Process> victim;
+	{
+		// Chosen and evicted under one lock, so a process claimed by a dispatch either is
+		// skipped here or finds its memory already gone
+		std::lock_guard<std::mutex> lock(allocationMapMutex);
 
-			if (!processName.empty() && index < oldestIndex) {
-				oldestIndex = index;
-				oldestProcessName = processName;
+		// The process at the lowest address is the oldest
+		size_t index = 0;
+		while (index < maximumSize) {
+			int pid = allocationMap[index];
+			if (pid == ProcessTable::NO_PID) {
+				index++;
+				continue;
+			}
+			if (pid != exceptPid) {
+				victim = ProcessRegistry::getInstance()->findByPid(pid);
+				if (victim && victim->getState() != Process::RUNNING) {
+					break;
+				}
+				victim = nullptr;
+			}
+			while (index < maximumSize && allocationMap[index] == pid) {
+				index++;
 			}
 		}
-		// If a valid process was found, retrieve the corresponding Screen object
-		if (!oldestProcessName.empty()) {
-			return ConsoleManager::getInstance()->getScreenByProcessName(oldestProcessName);
+
+		if (!victim) {
+			return ProcessTable::NO_PID;
 		}
+
+		size_t size = victim->getMemoryRequired();
+		SwapPool::getInstance()->swapOut(victim->getPid(), &memory[index], size, ConsoleManager::getInstance()->getMemPerFrame());
+		backingStore.push_back(victim);
+		deallocateAt(index, victim);
+		victim->setMemoryUsage(0);
+		victim->setMemoryPtr(nullptr);
 	}
-	return nullptr; // Return nullptr if no process is found
+
+	victim->setStateIf(Process::READY, Process::SWAPPED);
+	return victim->getPid();
 }
 
 // Find the starting index of a process in memory
-size_t FlatMemoryAllocator::findProcessStartIndex(const std::string& processName) {
-	for (const auto& entry : allocationMap) {
-		size_t index = entry.first;
-		const std::string& name = entry.second;
-
-		if (name == processName) {
-			return index;  // Return the starting index
-		}
+size_t FlatMemoryAllocator::findProcessStartIndex(int pid) {
+	auto it = std::find(allocationMap.begin(), allocationMap.end(), pid);
+	if (it != allocationMap.end()) {
+		return it - allocationMap.begin();  // Return the starting index
 	}
 	throw std::runtime_error("Process not found in memory allocation map."); // If process not found
 }
 
 // Deallocate memory for a process
 void FlatMemoryAllocator::deallocate(void* ptr, std::shared_ptr<Process> process) {
+	PROFILE_ZONE(FLAT_DEALLOCATE);
 	std::lock_guard<std::mutex> lock(allocationMapMutex);
 	size_t index = static_cast<char*>(ptr) - &memory[0];
 
-	if (allocationMap[index] != "") {
+	if (allocationMap[index] != ProcessTable::NO_PID) {
 		deallocateAt(index, process);
 	}
 	process->setMemoryUsage(0);
+	process->setMemoryPtr(nullptr);
 }
 
 // Visualize memory usage as a string
@@ -121,9 +166,10 @@ std::string FlatMemoryAllocator::visualizeMemory() {
 }
 
 // Get memory usage for a specific process
-size_t FlatMemoryAllocator::getProcessMemoryUsage(const std::string& processName) const {
-	if (processMemoryMap.find(processName) != processMemoryMap.end()) {
-		return processMemoryMap.at(processName);
+size_t FlatMemoryAllocator::getProcessMemoryUsage(int pid) const {
+	auto it = processMemoryMap.find(pid);
+	if (it != processMemoryMap.end()) {
+		return it->second;
 	}
 	return 0;  // Process not found
 }
@@ -141,39 +187,34 @@ size_t FlatMemoryAllocator::getTotalMemoryUsage() const {
 // Initialize memory and allocation map
 void FlatMemoryAllocator::initializeMemory() {
 	memory.resize(maximumSize, '.'); // Initialize the memory vector with '.'
-
-	for (size_t i = 0; i < maximumSize; ++i) {
-		allocationMap[i] = ""; // Initialize the allocationMap with empty strings
-	}
+	allocationMap.assign(maximumSize, ProcessTable::NO_PID); // Every byte starts out free
 }
 
-// Check if memory can be allocated at a specific index
+// Check if memory can be allocated at a specific index; the whole block must be free
 bool FlatMemoryAllocator::canAllocateAt(size_t index, size_t size) {
-	return (index + size <= maximumSize);
+	return index + size <= maximumSize &&
+		std::all_of(allocationMap.begin() + index, allocationMap.begin() + index + size, [](int pid) { return pid == ProcessTable::NO_PID; });
 }
 
 // Allocate memory at a specific index
-void FlatMemoryAllocator::allocateAt(size_t index, size_t size, string processName) {
-	for (size_t i = index; i < index + size; ++i) {
-		allocationMap[i] = processName; // Mark memory as allocated
-	}
+void FlatMemoryAllocator::allocateAt(size_t index, size_t size, int pid) {
+	std::fill_n(allocationMap.begin() + index, size, pid); // Mark memory as allocated
 	allocatedSize += size;
-	processMemoryMap[processName] += size;
+	processMemoryMap[pid] += size;
 }
 
 // Deallocate memory at a specific index
 void FlatMemoryAllocator::deallocateAt(size_t index, std::shared_ptr<Process> process) {
-	size_t size = ConsoleManager::getInstance()->getMinMemPerProc();
-	for (size_t i = index; i < index + size && i < maximumSize; ++i) {
-		allocationMap[i] = ""; // Mark memory as deallocated
-	}
+	size_t size = process->getMemoryRequired();
+	std::fill_n(allocationMap.begin() + index, std::min(size, maximumSize - index), ProcessTable::NO_PID); // Mark memory as deallocated
 	allocatedSize -= size;
 
 	// Deduct from process memory usage
-	if (processMemoryMap.find(process->getProcessName()) != processMemoryMap.end()) {
-		processMemoryMap[process->getProcessName()] -= size;
-		if (processMemoryMap[process->getProcessName()] == 0) {
-			processMemoryMap.erase(process->getProcessName());  // Clean up zero usage
+	auto it = processMemoryMap.find(process->getPid());
+	if (it != processMemoryMap.end()) {
+		it->second -= size;
+		if (it->second == 0) {
+			processMemoryMap.erase(it);  // Clean up zero usage
 		}
 	}
 }
@@ -185,12 +226,12 @@ void FlatMemoryAllocator::restoreFromBackingStore() {
 		backingStore.pop_back();
 
 		size_t memorySize = restoredProcess->getMemoryUsage();
-		std::string processName = restoredProcess->getProcessName();
+		int pid = restoredProcess->getPid();
 
 		// Attempt to reallocate memory for the process
-		void* restoredMemory = allocate(memorySize, processName, restoredProcess);
+		void* restoredMemory = allocate(memorySize, pid, restoredProcess);
 		if (restoredMemory) {
-			restoredProcess->setMemoryUsage(getProcessMemoryUsage(processName));
+			restoredProcess->setMemoryUsage(getProcessMemoryUsage(pid));
 			restoredProcess->setIsRunning(true);
 		}
 		else {
@@ -202,6 +243,7 @@ void FlatMemoryAllocator::restoreFromBackingStore() {
 
 // Visualize the contents of the backing store
 void FlatMemoryAllocator::visualizeBackingStore() {
+	std::lock_guard<std::mutex> lock(allocationMapMutex);
 	if (backingStore.empty()) {
 		std::cout << "Backing store is empty." << std::endl;
 		return;
@@ -242,21 +284,24 @@ void FlatMemoryAllocator::printMemoryInfo(int quantum_size) {
 	outFile << "Total External fragmentation in KB: " << calculateExternalFragmentation() << "\n\n";
 	outFile << "----end---- = " << maximumSize << "\n\n";
 
-	std::string currentProcessName = "";
-	std::string incomingProcessName = "";
+	int currentPid = ProcessTable::NO_PID;
+	int incomingPid = ProcessTable::NO_PID;
+
+	// Names are only looked up here, for display
+	auto nameOf = [](int pid) { return pid == ProcessTable::NO_PID ? std::string() : ProcessTable::getInstance()->name(pid); };
 
 	for (size_t i = maximumSize - 1; i > 0; i--) {
-		incomingProcessName = allocationMap[i];
-		if (currentProcessName.empty() && !incomingProcessName.empty()) {
-			currentProcessName = incomingProcessName;
-			outFile << i + 1 << "\n" << currentProcessName << "\n";
+		incomingPid = allocationMap[i];
+		if (currentPid == ProcessTable::NO_PID && incomingPid != ProcessTable::NO_PID) {
+			currentPid = incomingPid;
+			outFile << i + 1 << "\n" << nameOf(currentPid) << "\n";
 		}
-		else if (currentProcessName != incomingProcessName) {
+		else if (currentPid != incomingPid) {
 			outFile << i + 1 << "\n";
-			currentProcessName = incomingProcessName;
-			outFile << currentProcessName << "\n";
+			currentPid = incomingPid;
+			outFile << nameOf(currentPid) << "\n";
 		}
-		else if (incomingProcessName.empty() && i == maximumSize - 1) {
+		else if (incomingPid == ProcessTable::NO_PID && i == maximumSize - 1) {
 			outFile << i + 1 << "\n";
 		}
 	}
@@ -267,39 +312,23 @@ void FlatMemoryAllocator::printMemoryInfo(int quantum_size) {
 
 // Calculate external fragmentation
 size_t FlatMemoryAllocator::calculateExternalFragmentation() {
-	size_t externalFragmentation = 0;
-	for (size_t i = 0; i < maximumSize; i += 1) {
-		if (allocationMap[i] == "") {
-			externalFragmentation++;
-		}
-	}
-	return externalFragmentation;
+	return std::count(allocationMap.begin(), allocationMap.end(), ProcessTable::NO_PID);
 }
 
 // Get the number of processes in memory
 size_t FlatMemoryAllocator::getNumberOfProcessesInMemory() {
-	size_t allocatedBlocks = 0;
-	{
-		std::lock_guard<std::mutex> lock(allocationMapMutex);
-
-		// Iterate through the allocation map and count allocated blocks
-		for (size_t i = 0; i < allocationMap.size(); ++i) {
-			if (allocationMap.find(i) != allocationMap.end() && !allocationMap[i].empty()) {
-				allocatedBlocks++;
-			}
-		}
-	}
-	size_t processSizeInBlocks = ConsoleManager::getInstance()->getMinMemPerProc();  // Number of blocks per process
-	return allocatedBlocks / processSizeInBlocks;  // Total number of processes in memory
+	// Processes may differ in size, so count owners rather than blocks
+	std::lock_guard<std::mutex> lock(allocationMapMutex);
+	return processMemoryMap.size();
 }
 
 // Get a pointer to the memory block of a specific process
-void* FlatMemoryAllocator::getMemoryPtr(size_t size, string processName, std::shared_ptr<Process> process) {
+void* FlatMemoryAllocator::getMemoryPtr(size_t size, int pid) {
 	std::lock_guard<std::mutex> lock(allocationMapMutex);  // Ensure thread safety
 
 	// Iterate through the memory to find the block allocated to the process
 	for (size_t i = 0; i < maximumSize - size + 1; ++i) {
-		if (processName == allocationMap[i]) {
+		if (pid == allocationMap[i]) {
 			return &memory[i];  // Return pointer to the memory block
 		}
 	}
@@ -310,9 +339,11 @@ void* FlatMemoryAllocator::getMemoryPtr(size_t size, string processName, std::sh
 
 // Find and remove a process from the backing store
 void FlatMemoryAllocator::findAndRemoveProcessFromBackingStore(std::shared_ptr<Process> process) {
+	std::lock_guard<std::mutex> lock(allocationMapMutex);
+
 	// Iterate through the backing store to find the process
 	for (size_t i = 0; i < backingStore.size(); ++i) {
-		if (backingStore[i]->getProcessName() == process->getProcessName()) {
+		if (backingStore[i]->getPid() == process->getPid()) {
 			// Remove the process from the backing store
 			backingStore.erase(backingStore.begin() + i);
 			break;
@@ -326,6 +357,6 @@ size_t FlatMemoryAllocator::getAllocatedSize() {
 }
 
 // Get the current allocation map
-std::unordered_map<size_t, string> FlatMemoryAllocator::getAllocationMap() {
+const std::vector<int>& FlatMemoryAllocator::getAllocationMap() const {
 	return allocationMap;
 }
@@ -4,6 +4,7 @@
 #include <vector>
 #include <unordered_map>
 #include <queue>
+#include <mutex>
 
 #include "Process.h"
 
@@ -15,28 +16,28 @@ public:
 	~FlatMemoryAllocator();
 
 	FlatMemoryAllocator(size_t maximumSize);
-	void* allocate(size_t size, string process, std::shared_ptr<Process>);
-	size_t findProcessStartIndex(const std::string& processName);
+	void* allocate(size_t size, int pid, std::shared_ptr<Process>);
+	size_t findProcessStartIndex(int pid);
 	void visualizeBackingStore();
 	void deallocate(void* ptr, std::shared_ptr<Process>);
 	std::string visualizeMemory();
 	void visualizeMemoryASCII();
 	void initializeMemory();
 	bool canAllocateAt(size_t index, size_t size);
-	void allocateAt(size_t index, size_t size, string processName);
+	void allocateAt(size_t index, size_t size, int pid);
 	void deallocateAt(size_t index, std::shared_ptr<Process>);
 	void restoreFromBackingStore();
 	static FlatMemoryAllocator* getInstance();
 	static void initialize(size_t maximumMemorySize);
 	FlatMemoryAllocator() : maximumSize(0), allocatedSize(0) {};
-	size_t getProcessMemoryUsage(const std::string& processName) const;
+	size_t getProcessMemoryUsage(int pid) const;
 	void allocateFromBackingStore(std::shared_ptr<Process> process);
-	std::shared_ptr<Process> findOldestProcess();
-	void* getMemoryPtr(size_t size, string processName, std::shared_ptr<Process> process);
+	int swapOutOldest(int exceptPid);
+	void* getMemoryPtr(size_t size, int pid);
 	void findAndRemoveProcessFromBackingStore(std::shared_ptr<Process> process);
 	void displayAllocationMap() const;
 	size_t getAllocatedSize();
-	std::unordered_map<size_t, string> getAllocationMap();
+	const std::vector<int>& getAllocationMap() const;
 
 	size_t getTotalMemoryUsage() const;
 
@@ -50,7 +51,8 @@ private:
 	size_t maximumSize;
 	size_t allocatedSize;
 	std::vector<char> memory;
-	std::unordered_map<size_t, string> allocationMap;
-	std::unordered_map<std::string, size_t> processMemoryMap;
+	std::vector<int> allocationMap; // Owning PID of each byte
+	std::unordered_map<int, size_t> processMemoryMap;
 	std::vector<shared_ptr<Process>> backingStore;
+	mutable std::mutex allocationMapMutex; // Protects allocationMap and backingStore
 };
\ No newline at end of file
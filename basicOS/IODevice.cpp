@@ -0,0 +1,92 @@
+#include <algorithm>
+
+#include "IODevice.h"
+
+using namespace std;
+
+IODevice::IODevice(int id, int latencyTicks) : id(id), latencyTicks(latencyTicks)
+{
+}
+
+IODevice::~IODevice()
+{
+	stop();
+}
+
+// onComplete hands the process back to the scheduler
+void IODevice::start(std::function<void(std::shared_ptr<Process>)> onComplete) {
+	this->onComplete = onComplete;
+	running = true;
+}
+
+void IODevice::stop() {
+	{
+		std::lock_guard<std::mutex> lock(requestQueueMutex);
+		running = false;
+	}
+	TimerWheel::getInstance()->cancel(serviceTimer);
+}
+
+// Queue a request; false if the device is stopped and will not serve it
+bool IODevice::submit(std::shared_ptr<Process> process) {
+	bool idle;
+	{
+		std::lock_guard<std::mutex> lock(requestQueueMutex);
+		if (!running) {
+			return false;
+		}
+		requestQueue.push(process);
+		idle = requestQueue.size() == 1;
+	}
+
+	if (idle) {
+		startNextRequest();
+	}
+	return true;
+}
+
+// Serve the request at the head of the queue
+void IODevice::startNextRequest() {
+	if (!running) {
+		return;
+	}
+
+	TimerWheel::getInstance()->schedule(serviceTimer, std::max(latencyTicks, 1), [this]() { completeRequest(); });
+}
+
+void IODevice::completeRequest() {
+	std::shared_ptr<Process> process;
+	bool morePending;
+	{
+		std::lock_guard<std::mutex> lock(requestQueueMutex);
+		process = requestQueue.front();
+		requestQueue.pop();
+		morePending = !requestQueue.empty();
+	}
+
+	busyTicks += std::max(latencyTicks, 1);
+	numCompleted++;
+
+	if (morePending) {
+		startNextRequest();
+	}
+	onComplete(process);
+}
+
+int IODevice::getId() const {
+	return id;
+}
+
+// Requests waiting, including the one being served
+size_t IODevice::getQueueLength() {
+	std::lock_guard<std::mutex> lock(requestQueueMutex);
+	return requestQueue.size();
+}
+
+size_t IODevice::getNumCompleted() const {
+	return numCompleted;
+}
+
+size_t IODevice::getBusyTicks() const {
+	return busyTicks;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <queue>
+#include <mutex>
+#include <functional>
+#include <memory>
+#include <atomic>
+
+#include "Process.h"
+#include "TimerWheel.h"
+
+// A simulated I/O device. Requests are served one at a time in FIFO order,
+// each taking latencyTicks of sim time; the process waits off-core until its request completes.
+// Service time is a timer on the sim clock, so a device needs no thread of its own.
+// A stopped device turns requests away instead of queueing requests it would never serve.
+class IODevice
+{
+public:
+	IODevice(int id, int latencyTicks);
+	~IODevice();
+
+	void start(std::function<void(std::shared_ptr<Process>)> onComplete);
+	void stop();
+	bool submit(std::shared_ptr<Process> process);
+
+	int getId() const;
+	size_t getQueueLength();
+	size_t getNumCompleted() const;
+	size_t getBusyTicks() const;
+
+private:
+	void startNextRequest();
+	void completeRequest();
+
+	int id;
+	int latencyTicks;
+	std::atomic<bool> running = false;
+	std::atomic<size_t> numCompleted = 0;
+	std::atomic<size_t> busyTicks = 0;
+	std::function<void(std::shared_ptr<Process>)> onComplete;
+	std::queue<std::shared_ptr<Process>> requestQueue;
+	std::mutex requestQueueMutex;
+	TimerWheel::Timer serviceTimer;
+};
@@ -1,10 +1,18 @@
 #include <iostream>
+#include <iterator>
 
 #include "InputHandler.h"
 #include "ConsoleManager.h"
 #include "FlatMemoryAllocator.h"
 #include "PagingAllocator.h"
 #include "Process.h"
+#include "ObjectPool.h"
+#include "ProcessRegistry.h"
+#include "Benchmark.h"
+#include "Telemetry.h"
+#include "EventTrace.h"
+#include "Profiler.h"
+#include "Platform.h"
 
 using namespace std;
 
@@ -62,6 +70,12 @@ void InputHandler::handleMainConsoleInput()
     // Main Console commands
     if (ConsoleManager::getInstance()->getCurrentConsole()->getConsoleName() == MAIN_CONSOLE) {
         if (command == "initialize") {
+            // A flat process keeps its symbol table inside its own block, so the block must hold it
+            if (ConsoleManager::getInstance()->getMinMemPerProc() == ConsoleManager::getInstance()->getMaxMemPerProc()
+                && ConsoleManager::getInstance()->getMinMemPerProc() < ExecutionState::SYMBOL_TABLE_SIZE) {
+                cout << ConsoleColor::RED << "Error: flat memory needs at least " << ExecutionState::SYMBOL_TABLE_SIZE << " bytes per process for its variables." << ConsoleColor::RESET << endl;
+                return;
+            }
             if (!ConsoleManager::getInstance()->getInitialized()) {
                 ConsoleManager::getInstance()->setInitialized(true);
 
@@ -72,6 +86,11 @@ void InputHandler::handleMainConsoleInput()
                     });
                 schedulerThread.detach();
 
+                // Start merging identical pages in the background
+                if (ConsoleManager::getInstance()->getMinMemPerProc() != ConsoleManager::getInstance()->getMaxMemPerProc()) {
+                    PagingAllocator::getInstance()->startPageMerging(ConsoleManager::getInstance()->getPageMergeInterval());
+                }
+
                 cout << ConsoleColor::GREEN << "System initialized successfully with:" << ConsoleColor::RESET << endl;
 				cout << ConsoleColor::GREEN << "Number of CPUs: " << ConsoleManager::getInstance()->getNumCpu() << ConsoleColor::RESET << endl;
 				cout << ConsoleColor::GREEN << "Scheduler Configuration: " << ConsoleManager::getInstance()->getSchedulerConfig() << ConsoleColor::RESET << endl;
@@ -87,6 +106,12 @@ void InputHandler::handleMainConsoleInput()
 				cout << ConsoleColor::GREEN << "Memory per Frame: " << ConsoleManager::getInstance()->getMemPerFrame() << ConsoleColor::RESET << endl;
 				cout << ConsoleColor::GREEN << "Min Memory per Process: " << ConsoleManager::getInstance()->getMinMemPerProc() << ConsoleColor::RESET << endl;
 				cout << ConsoleColor::GREEN <<"Max Memory per Process: " << ConsoleManager::getInstance()->getMaxMemPerProc() << ConsoleColor::RESET << endl;
+				cout << ConsoleColor::GREEN << "Page Merge Interval: " << ConsoleManager::getInstance()->getPageMergeInterval() << ConsoleColor::RESET << endl;
+				cout << ConsoleColor::GREEN << "Page Table Levels: " << ConsoleManager::getInstance()->getPageTableLevels() << ConsoleColor::RESET << endl;
+				cout << ConsoleColor::GREEN << "Executor Threads: " << ConsoleManager::getInstance()->getExecutorThreads() << ConsoleColor::RESET << endl;
+				cout << ConsoleColor::GREEN << "Tick Duration: " << ConsoleManager::getInstance()->getTickDuration() << " ms" << ConsoleColor::RESET << endl;
+				cout << ConsoleColor::GREEN << "I/O Frequency: " << ConsoleManager::getInstance()->getIoFrequency() << "%, Latency: " << ConsoleManager::getInstance()->getIoLatency() << " ticks, Devices: " << ConsoleManager::getInstance()->getNumIoDevices() << ConsoleColor::RESET << endl;
+				cout << ConsoleColor::GREEN << "Telemetry: every " << ConsoleManager::getInstance()->getTelemetryInterval() << " ticks, last " << ConsoleManager::getInstance()->getTelemetryCapacity() << " samples kept" << ConsoleColor::RESET << endl;
                 cout << "------------------------------------------------" << endl;
             }
             else {
@@ -124,9 +149,37 @@ void InputHandler::handleMainConsoleInput()
             ConsoleManager::getInstance()->reportUtil();
         }
         else if (command == "clear") {
-            system("cls");
+            system(CLEAR_SCREEN_COMMAND);
             ConsoleManager::getInstance()->drawConsole();
         }
+        else if (command == "vmstat" && tokens.size() > 1) {
+            // vmstat -i <ticks> [count] streams samples; vmstat --export <file> writes the ring buffer
+            if (tokens[1] == "-i" && tokens.size() > 2) {
+                try {
+                    int intervalTicks = stoi(tokens[2]);
+                    int count = (tokens.size() > 3) ? stoi(tokens[3]) : 10;
+                    ConsoleManager::getInstance()->printVmstatInterval(std::max(1, intervalTicks), count);
+                }
+                catch (const std::exception&) {
+                    cout << ConsoleColor::RED << "Usage: vmstat -i <ticks> [count]" << ConsoleColor::RESET << endl;
+                }
+            }
+            else if (tokens[1] == "--export" && tokens.size() > 2) {
+                string fileName = tokens[2];
+                bool csv = fileName.size() >= 4 && fileName.compare(fileName.size() - 4, 4, ".csv") == 0;
+                bool exported = csv ? Telemetry::getInstance()->exportCsv(fileName) : Telemetry::getInstance()->exportBinary(fileName);
+
+                if (exported) {
+                    cout << ConsoleColor::GREEN << "Telemetry written to " << fileName << ConsoleColor::RESET << endl;
+                }
+                else {
+                    cout << ConsoleColor::RED << "Error writing " << fileName << ConsoleColor::RESET << endl;
+                }
+            }
+            else {
+                cout << ConsoleColor::RED << "Usage: vmstat [-i <ticks> [count]] [--export <file.csv|file.bin>]" << ConsoleColor::RESET << endl;
+            }
+        }
         else if (command == "vmstat") {
             if (ConsoleManager::getInstance()->getMinMemPerProc() == ConsoleManager::getInstance()->getMaxMemPerProc()) {
                 size_t memoryUsage = FlatMemoryAllocator::getInstance()->getTotalMemoryUsage();
@@ -141,20 +194,61 @@ void InputHandler::handleMainConsoleInput()
         else if (command == "process-smi") {
 			ConsoleManager::getInstance()->printProcessSmi();
         }
+        else if (command == "profile") {
+            if (tokens.size() > 1 && tokens[1] == "reset") {
+                Profiler::getInstance()->reset();
+                cout << ConsoleColor::GREEN << "Profile counters cleared." << ConsoleColor::RESET << endl;
+            }
+            else {
+                Profiler::getInstance()->print();
+            }
+        }
+        else if (command == "trace") {
+            // trace start | trace stop | trace dump <file>
+            string traceCommand = (tokens.size() > 1) ? tokens[1] : "";
+
+            if (traceCommand == "start") {
+                EventTrace::getInstance()->start(ConsoleManager::getInstance()->getNumCpu(), ConsoleManager::getInstance()->getTraceBufferEvents());
+                cout << ConsoleColor::GREEN << "Tracing started, " << ConsoleManager::getInstance()->getTraceBufferEvents() << " events per core." << ConsoleColor::RESET << endl;
+            }
+            else if (traceCommand == "stop") {
+                EventTrace::getInstance()->stop();
+                cout << ConsoleColor::GREEN << "Tracing stopped, " << EventTrace::getInstance()->getNumEvents() << " events recorded, "
+                    << EventTrace::getInstance()->getNumOverwritten() << " overwritten." << ConsoleColor::RESET << endl;
+            }
+            else if (traceCommand == "dump" && tokens.size() > 2) {
+                if (EventTrace::getInstance()->dump(tokens[2])) {
+                    cout << ConsoleColor::GREEN << "Trace written to " << tokens[2] << ConsoleColor::RESET << endl;
+                }
+                else {
+                    cout << ConsoleColor::RED << "Error writing " << tokens[2] << ConsoleColor::RESET << endl;
+                }
+            }
+            else {
+                cout << ConsoleColor::RED << "Usage: trace start | trace stop | trace dump <file>" << ConsoleColor::RESET << endl;
+            }
+        }
+        else if (command == "benchmark") {
+            if (tokens.size() > 1) {
+                Benchmark::run(tokens[1]);
+            }
+            else {
+                cout << ConsoleColor::RED << "Usage: benchmark <name>" << ConsoleColor::RESET << endl;
+            }
+        }
         else if (command == "screen") {
             if (tokens.size() > 1) {
                 string screenCommand = tokens[1];
                 string processName = (tokens.size() > 2) ? tokens[2] : "";
 
                 if (screenCommand == "-s" && !processName.empty()) {
-                    if (ConsoleManager::getInstance()->getScreenMap().contains(processName)) {
+                    // The generator may take the name between the check and the registration
+                    auto screenInstance = ProcessRegistry::getInstance()->contains(processName) ? nullptr
+                        : makePooled<Process>(processName, 0, time(nullptr), ConsoleManager::getInstance()->getMinMemPerProc());
+                    if (!screenInstance || !ConsoleManager::getInstance()->registerConsole(screenInstance)) {
                         cout << ConsoleColor::YELLOW << "Screen already exists." << ConsoleColor::RESET << endl;
                     }
                     else {
-                        string timestamp = ConsoleManager::getInstance()->getCurrentTimestamp();
-                        auto screenInstance = std::make_shared<Process>(processName, 0, timestamp, ConsoleManager::getInstance()->getMinMemPerProc());
-                        ConsoleManager::getInstance()->registerConsole(screenInstance);
-
                         ConsoleManager::getInstance()->switchConsole(processName);
                         ConsoleManager::getInstance()->drawConsole();
                         Scheduler::getInstance()->addProcessToQueue(screenInstance);
@@ -164,6 +258,44 @@ void InputHandler::handleMainConsoleInput()
                     ConsoleManager::getInstance()->switchConsole(processName);
                     ConsoleManager::getInstance()->drawConsole();
                 }
+                else if (screenCommand == "-ls" && tokens.size() > 2) {
+                    // screen -ls [--state <state>] [--sort <key>] [--limit <n>] [--page <n>]
+                    string state = "running";
+                    string sort = "pid";
+                    int limit = 50;
+                    int page = 1;
+                    bool valid = true;
+
+                    for (size_t i = 2; i < tokens.size() && valid; i += 2) {
+                        if (i + 1 >= tokens.size()) {
+                            valid = false;
+                        }
+                        else if (tokens[i] == "--state") {
+                            state = tokens[i + 1];
+                        }
+                        else if (tokens[i] == "--sort") {
+                            sort = tokens[i + 1];
+                        }
+                        else if (tokens[i] == "--limit" || tokens[i] == "--page") {
+                            try {
+                                (tokens[i] == "--limit" ? limit : page) = stoi(tokens[i + 1]);
+                            }
+                            catch (const std::exception&) {
+                                valid = false;
+                            }
+                        }
+                        else {
+                            valid = false;
+                        }
+                    }
+
+                    if (valid) {
+                        ConsoleManager::getInstance()->displayProcessList(state, sort, limit, page);
+                    }
+                    else {
+                        cout << ConsoleColor::RED << "Usage: screen -ls [--state <state>] [--sort <key>] [--limit <n>] [--page <n>]" << ConsoleColor::RESET << endl;
+                    }
+                }
                 else if (screenCommand == "-ls") {
                     ConsoleManager::getInstance()->displayProcessList();
                     if (ConsoleManager::getInstance()->getMinMemPerProc() == ConsoleManager::getInstance()->getMaxMemPerProc()) {
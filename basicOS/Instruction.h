@@ -5,7 +5,13 @@ public:
 	enum CommandType
 	{
 		IO,
-		PRINT
+		PRINT,
+		DECLARE,
+		ADD,
+		SUBTRACT,
+		SLEEP,
+		FOR,
+		END_FOR
 	};
 
 	Instruction(int pid, CommandType commandType);
@@ -17,4 +23,3 @@ protected:
 	CommandType commandType;
 };
 
-
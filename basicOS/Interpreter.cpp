@@ -0,0 +1,118 @@
+#include <algorithm>
+
+#include "Interpreter.h"
+
+using namespace std;
+
+// The instruction retries next tick, unless it has already waited too long
+static Interpreter::StepResult stall(ExecutionState& state) {
+	if (++state.stalls >= ExecutionState::MAX_STALLS) {
+		state.faulted = true;
+		return Interpreter::FAULTED;
+	}
+	return Interpreter::STALLED;
+}
+
+// Run loop control until one counted instruction has executed
+Interpreter::StepResult Interpreter::step(ExecutionState& state) {
+	const uint32_t programSize = static_cast<uint32_t>(state.program.size());
+	VariableStore* memory = state.memory;
+
+	// Variables start at zero in the process's symbol table
+	if (!state.symbolTableInitialized) {
+		for (int slot = 0; slot < ExecutionState::MAX_VARIABLES; slot++) {
+			if (!memory->writeVariable(slot, 0)) {
+				return stall(state);
+			}
+		}
+		state.symbolTableInitialized = true;
+	}
+
+	while (state.programCounter < programSize) {
+		const Bytecode& instruction = state.program[state.programCounter];
+		uint16_t value1 = instruction.operand1;
+		uint16_t value2 = instruction.operand2;
+		uint16_t result = 0;
+		bool writesResult = false;
+
+		if (instruction.opcode != Instruction::FOR && instruction.opcode != Instruction::END_FOR) {
+			if (!(instruction.flags & Bytecode::IMMEDIATE_1) && !memory->readVariable(instruction.operand1 % ExecutionState::MAX_VARIABLES, value1)) {
+				return stall(state);
+			}
+			if (!(instruction.flags & Bytecode::IMMEDIATE_2) && (instruction.opcode == Instruction::ADD || instruction.opcode == Instruction::SUBTRACT)
+				&& !memory->readVariable(instruction.operand2 % ExecutionState::MAX_VARIABLES, value2)) {
+				return stall(state);
+			}
+		}
+
+		switch (instruction.opcode) {
+		case Instruction::FOR:
+			state.loops[state.loopDepth++] = { state.programCounter + 1, instruction.operand1 };
+			state.programCounter++;
+			continue;
+
+		case Instruction::END_FOR: {
+			ExecutionState::LoopFrame& loop = state.loops[state.loopDepth - 1];
+			if (--loop.remaining > 0) {
+				state.programCounter = loop.start;
+			}
+			else {
+				state.loopDepth--;
+				state.programCounter++;
+			}
+			continue;
+		}
+
+		case Instruction::DECLARE:
+			result = value1;
+			writesResult = true;
+			break;
+
+		// Values are unsigned 16-bit and clamp instead of wrapping
+		case Instruction::ADD:
+			result = static_cast<uint16_t>(std::min<uint32_t>(uint32_t(value1) + value2, UINT16_MAX));
+			writesResult = true;
+			break;
+
+		case Instruction::SUBTRACT:
+			result = value1 > value2 ? value1 - value2 : 0;
+			writesResult = true;
+			break;
+
+		case Instruction::SLEEP:
+			state.sleepTicks = value1;
+			break;
+
+		case Instruction::PRINT: {
+			ExecutionState::LogEntry& entry = state.logs[state.numLogs % ExecutionState::LOG_SIZE];
+			entry = { state.executed, static_cast<uint8_t>(instruction.operand1), value1 };
+			state.numLogs++;
+			break;
+		}
+
+		case Instruction::IO:
+			state.ioDevice = instruction.operand1;
+			break;
+
+		default:
+			break;
+		}
+
+		// Retry the whole instruction next tick if the write faults
+		if (writesResult && !memory->writeVariable(instruction.dest, result)) {
+			return stall(state);
+		}
+
+		state.stalls = 0;
+		state.programCounter++;
+		state.executed++;
+		instructionsExecuted++;
+		return instruction.opcode == Instruction::IO ? BLOCKED : EXECUTED;
+	}
+
+	return FINISHED;
+}
+
+uint64_t Interpreter::getInstructionsExecuted() const {
+	return instructionsExecuted;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Bytecode.h"
+
+// Executes process bytecode. Each core owns one interpreter, which also counts
+// the instructions that core has executed. An instruction stalls when its
+// variables cannot be read or written yet (no frame for a copy-on-write fault),
+// faults once it has stalled for MAX_STALLS ticks in a row, and blocks after
+// an IO instruction until the device completes the request.
+class Interpreter
+{
+public:
+	enum StepResult
+	{
+		EXECUTED,
+		BLOCKED,
+		STALLED,
+		FAULTED,
+		FINISHED
+	};
+
+	StepResult step(ExecutionState& state);
+	uint64_t getInstructionsExecuted() const;
+
+private:
+	uint64_t instructionsExecuted = 0;
+};
@@ -0,0 +1,141 @@
+#include <cstring>
+#include <algorithm>
+
+#include "LZCodec.h"
+
+using namespace std;
+
+namespace {
+	const size_t MIN_MATCH = 4;
+	const size_t MAX_OFFSET = 65535;
+	const int HASH_BITS = 12;
+
+	uint32_t hash4(const char* p) {
+		uint32_t value;
+		memcpy(&value, p, sizeof(value));
+		return (value * 2654435761u) >> (32 - HASH_BITS);
+	}
+
+	// Lengths of 15 or more spill into extra bytes of 255 plus a remainder
+	void writeLength(std::vector<uint8_t>& output, size_t length) {
+		while (length >= 255) {
+			output.push_back(255);
+			length -= 255;
+		}
+		output.push_back(static_cast<uint8_t>(length));
+	}
+
+	bool readLength(const uint8_t*& ip, const uint8_t* end, size_t& length) {
+		uint8_t byte;
+		do {
+			if (ip >= end) {
+				return false;
+			}
+			byte = *ip++;
+			length += byte;
+		} while (byte == 255);
+		return true;
+	}
+
+	void emitSequence(std::vector<uint8_t>& output, const char* literals, size_t numLiterals, size_t offset, size_t matchLength) {
+		size_t matchCode = matchLength >= MIN_MATCH ? matchLength - MIN_MATCH : 0;
+		uint8_t token = static_cast<uint8_t>((std::min<size_t>(numLiterals, 15) << 4) | std::min<size_t>(matchCode, 15));
+		output.push_back(token);
+
+		if (numLiterals >= 15) {
+			writeLength(output, numLiterals - 15);
+		}
+		output.insert(output.end(), literals, literals + numLiterals);
+
+		if (matchLength >= MIN_MATCH) {
+			output.push_back(static_cast<uint8_t>(offset & 0xFF));
+			output.push_back(static_cast<uint8_t>(offset >> 8));
+			if (matchCode >= 15) {
+				writeLength(output, matchCode - 15);
+			}
+		}
+	}
+}
+
+// Output ends with a literal-only sequence so the decoder knows where to stop
+void LZCodec::compress(const char* input, size_t size, std::vector<uint8_t>& output) {
+	output.clear();
+	output.reserve(size / 2 + 16);
+
+	size_t hashTable[1 << HASH_BITS];
+	std::fill_n(hashTable, 1 << HASH_BITS, SIZE_MAX);
+
+	size_t anchor = 0;
+	size_t pos = 0;
+
+	while (size >= MIN_MATCH && pos <= size - MIN_MATCH) {
+		uint32_t h = hash4(input + pos);
+		size_t candidate = hashTable[h];
+		hashTable[h] = pos;
+
+		if (candidate != SIZE_MAX && pos - candidate <= MAX_OFFSET && memcmp(input + candidate, input + pos, MIN_MATCH) == 0) {
+			size_t matchLength = MIN_MATCH;
+			while (pos + matchLength < size && input[candidate + matchLength] == input[pos + matchLength]) {
+				matchLength++;
+			}
+
+			emitSequence(output, input + anchor, pos - anchor, pos - candidate, matchLength);
+			pos += matchLength;
+			anchor = pos;
+		}
+		else {
+			pos++;
+		}
+	}
+
+	emitSequence(output, input + anchor, size - anchor, 0, 0);
+}
+
+bool LZCodec::decompress(const uint8_t* input, size_t size, char* output, size_t outputSize) {
+	const uint8_t* ip = input;
+	const uint8_t* end = input + size;
+	size_t op = 0;
+
+	while (ip < end) {
+		uint8_t token = *ip++;
+
+		size_t numLiterals = token >> 4;
+		if (numLiterals == 15 && !readLength(ip, end, numLiterals)) {
+			return false;
+		}
+		if (numLiterals > static_cast<size_t>(end - ip) || op + numLiterals > outputSize) {
+			return false;
+		}
+		memcpy(output + op, ip, numLiterals);
+		ip += numLiterals;
+		op += numLiterals;
+
+		// The last sequence has no match
+		if (ip == end) {
+			break;
+		}
+
+		if (end - ip < 2) {
+			return false;
+		}
+		size_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+
+		size_t matchLength = token & 0x0F;
+		if (matchLength == 15 && !readLength(ip, end, matchLength)) {
+			return false;
+		}
+		matchLength += MIN_MATCH;
+
+		if (offset == 0 || offset > op || op + matchLength > outputSize) {
+			return false;
+		}
+
+		// Copy byte by byte: the match may overlap the bytes it produces
+		for (size_t i = 0; i < matchLength; i++, op++) {
+			output[op] = output[op - offset];
+		}
+	}
+
+	return op == outputSize;
+}
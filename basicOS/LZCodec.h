@@ -0,0 +1,14 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Byte-oriented LZ77 codec in the style of LZ4: sequences of literals followed by
+// a back-reference (offset, length). Fast enough to sit on the swap path.
+class LZCodec
+{
+public:
+	static void compress(const char* input, size_t size, std::vector<uint8_t>& output);
+	static bool decompress(const uint8_t* input, size_t size, char* output, size_t outputSize);
+};
@@ -0,0 +1,67 @@
+#include <bit>
+#include <algorithm>
+
+#include "LatencyHistogram.h"
+
+using namespace std;
+
+void LatencyHistogram::record(uint64_t value) {
+	counts[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+	count.fetch_add(1, std::memory_order_relaxed);
+	sum.fetch_add(value, std::memory_order_relaxed);
+
+	uint64_t currentMax = max.load(std::memory_order_relaxed);
+	while (value > currentMax && !max.compare_exchange_weak(currentMax, value, std::memory_order_relaxed)) {
+	}
+}
+
+uint64_t LatencyHistogram::getCount() const {
+	return count;
+}
+
+uint64_t LatencyHistogram::getMax() const {
+	return max;
+}
+
+double LatencyHistogram::getMean() const {
+	uint64_t numValues = count;
+	return numValues > 0 ? static_cast<double>(sum) / numValues : 0.0;
+}
+
+// Smallest value that at least percentile percent of the recorded values do not exceed
+uint64_t LatencyHistogram::getPercentile(double percentile) const {
+	uint64_t numValues = count;
+	if (numValues == 0) {
+		return 0;
+	}
+
+	uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(percentile / 100.0 * numValues + 0.5));
+	uint64_t seen = 0;
+	for (int bucket = 0; bucket < NUM_BUCKETS; bucket++) {
+		seen += counts[bucket].load(std::memory_order_relaxed);
+		if (seen >= target) {
+			return std::min(highestInBucket(bucket), getMax());
+		}
+	}
+	return getMax();
+}
+
+// Exact below SUB_BUCKETS; above, the top SUB_BITS bits after the leading one pick the sub-bucket
+int LatencyHistogram::bucketOf(uint64_t value) {
+	if (value < SUB_BUCKETS) {
+		return static_cast<int>(value);
+	}
+
+	int shift = (63 - std::countl_zero(value)) - SUB_BITS;
+	return (shift + 1) * SUB_BUCKETS + static_cast<int>((value >> shift) - SUB_BUCKETS);
+}
+
+uint64_t LatencyHistogram::highestInBucket(int bucket) {
+	if (bucket < SUB_BUCKETS) {
+		return bucket;
+	}
+
+	int shift = bucket / SUB_BUCKETS - 1;
+	uint64_t lowest = static_cast<uint64_t>(bucket % SUB_BUCKETS + SUB_BUCKETS) << shift;
+	return lowest + ((uint64_t(1) << shift) - 1);
+}
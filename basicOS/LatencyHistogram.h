@@ -0,0 +1,31 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Log-bucketed histogram in the style of HdrHistogram: values below SUB_BUCKETS are exact,
+// larger ones fall into SUB_BUCKETS buckets per power of two, so every recorded value
+// is known to within about 3%. Recording is lock-free and never allocates.
+class LatencyHistogram
+{
+public:
+	static const int SUB_BITS = 5;
+	static const int SUB_BUCKETS = 1 << SUB_BITS;
+	static const int NUM_BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+	void record(uint64_t value);
+
+	uint64_t getCount() const;
+	uint64_t getMax() const;
+	double getMean() const;
+	uint64_t getPercentile(double percentile) const;
+
+private:
+	static int bucketOf(uint64_t value);
+	static uint64_t highestInBucket(int bucket);
+
+	std::atomic<uint64_t> counts[NUM_BUCKETS] = {};
+	std::atomic<uint64_t> count = 0;
+	std::atomic<uint64_t> sum = 0;
+	std::atomic<uint64_t> max = 0;
+};
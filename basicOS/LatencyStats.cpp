@@ -0,0 +1,84 @@
+#include <iomanip>
+#include <algorithm>
+
+#include "LatencyStats.h"
+#include "Machine.h"
+#include "ProcessTable.h"
+#include "TimerWheel.h"
+
+using namespace std;
+
+LatencyStats* LatencyStats::latencyStats = nullptr;
+
+LatencyStats* LatencyStats::getInstance() {
+	LatencyStats*& instance = Machine::slot(&Machine::latencyStats, latencyStats);
+	if (instance == nullptr) {
+		instance = new LatencyStats();
+	}
+	return instance;
+}
+
+// Record into the histograms of the named policy from now on
+void LatencyStats::setPolicy(const std::string& policy) {
+	std::lock_guard<std::mutex> lock(policiesMutex);
+	std::unique_ptr<PolicyHistograms>& histograms = policies[policy];
+	if (!histograms) {
+		histograms = std::make_unique<PolicyHistograms>();
+	}
+	current = histograms.get();
+}
+
+// The process went back to the ready queue; its wait starts now
+void LatencyStats::recordReady(int pid) {
+	ProcessTable::getInstance()->readyTick(pid) = TimerWheel::getInstance()->getCurrentTick();
+}
+
+// The process got a core: close its current wait, and on the first dispatch record its response time
+void LatencyStats::recordDispatch(int pid) {
+	ProcessTable* table = ProcessTable::getInstance();
+	uint64_t now = TimerWheel::getInstance()->getCurrentTick();
+
+	table->waitTicks(pid) += now - std::min(table->readyTick(pid), now);
+
+	PolicyHistograms* histograms = current;
+	if (table->firstRunTick(pid) == ProcessTable::NO_TICK) {
+		table->firstRunTick(pid) = now;
+		if (histograms) {
+			histograms->response.record(now - std::min(table->arrivalTick(pid), now));
+		}
+	}
+}
+
+void LatencyStats::recordCompletion(int pid) {
+	PolicyHistograms* histograms = current;
+	if (!histograms) {
+		return;
+	}
+
+	ProcessTable* table = ProcessTable::getInstance();
+	uint64_t now = TimerWheel::getInstance()->getCurrentTick();
+	histograms->waiting.record(table->waitTicks(pid));
+	histograms->turnaround.record(now - std::min(table->arrivalTick(pid), now));
+}
+
+void LatencyStats::printReport(std::ostream& out) {
+	std::lock_guard<std::mutex> lock(policiesMutex);
+
+	for (const auto& policy : policies) {
+		const PolicyHistograms& histograms = *policy.second;
+		out << "Scheduling latency in ticks (" << policy.first << ", " << histograms.turnaround.getCount() << " processes):" << endl;
+		out << std::left << setw(12) << "" << std::right << setw(8) << "p50" << setw(8) << "p95" << setw(8) << "p99" << setw(8) << "max" << setw(10) << "mean" << endl;
+
+		const std::pair<const char*, const LatencyHistogram*> rows[] = {
+			{ "waiting", &histograms.waiting },
+			{ "response", &histograms.response },
+			{ "turnaround", &histograms.turnaround }
+		};
+		for (const auto& row : rows) {
+			out << std::left << setw(12) << row.first << std::right
+				<< setw(8) << row.second->getPercentile(50) << setw(8) << row.second->getPercentile(95)
+				<< setw(8) << row.second->getPercentile(99) << setw(8) << row.second->getMax()
+				<< setw(10) << fixed << setprecision(1) << row.second->getMean() << defaultfloat << endl;
+		}
+	}
+}
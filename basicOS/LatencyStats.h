@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <ostream>
+
+#include "LatencyHistogram.h"
+
+// Scheduling latency of finished processes in sim ticks, one set of histograms per policy:
+// waiting is the total time spent ready but off-core, response the time from arrival
+// to the first dispatch, and turnaround the time from arrival to completion.
+class LatencyStats
+{
+public:
+	struct PolicyHistograms
+	{
+		LatencyHistogram waiting;
+		LatencyHistogram response;
+		LatencyHistogram turnaround;
+	};
+
+	static LatencyStats* getInstance();
+
+	void setPolicy(const std::string& policy);
+
+	// Per-process events, called by the scheduler
+	void recordReady(int pid);
+	void recordDispatch(int pid);
+	void recordCompletion(int pid);
+
+	void printReport(std::ostream& out);
+
+private:
+	static LatencyStats* latencyStats;
+	std::map<std::string, std::unique_ptr<PolicyHistograms>> policies;
+	std::atomic<PolicyHistograms*> current = nullptr;
+	std::mutex policiesMutex;
+};
@@ -0,0 +1,56 @@
+#include "Machine.h"
+#include "ConsoleManager.h"
+#include "Scheduler.h"
+#include "TimerWheel.h"
+#include "FlatMemoryAllocator.h"
+#include "PagingAllocator.h"
+#include "SwapPool.h"
+#include "ProcessTable.h"
+#include "ProcessRegistry.h"
+#include "ProcessHistory.h"
+#include "LatencyStats.h"
+#include "Telemetry.h"
+#include "EventTrace.h"
+#include "Random.h"
+
+thread_local Machine* Machine::active = nullptr;
+
+// Stop the scheduler first, release the processes, then the bookkeeping they report to
+Machine::~Machine()
+{
+	Machine* previous = active;
+	active = this;
+
+	delete scheduler;
+	scheduler = nullptr;
+	delete consoleManager;
+	consoleManager = nullptr;
+	delete flatMemoryAllocator;
+	flatMemoryAllocator = nullptr;
+	delete pagingAllocator;
+	pagingAllocator = nullptr;
+	delete swapPool;
+	swapPool = nullptr;
+	delete telemetry;
+	delete latencyStats;
+	delete eventTrace;
+	delete processHistory;
+	delete processRegistry;
+	delete processTable;
+	delete timerWheel;
+	delete random;
+
+	active = previous == this ? nullptr : previous;
+}
+
+void Machine::enter() {
+	active = this;
+}
+
+void Machine::leave() {
+	active = nullptr;
+}
+
+Machine* Machine::current() {
+	return active;
+}
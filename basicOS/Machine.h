@@ -0,0 +1,56 @@
+#pragma once
+
+class ConsoleManager;
+class Scheduler;
+class TimerWheel;
+class FlatMemoryAllocator;
+class PagingAllocator;
+class SwapPool;
+class ProcessTable;
+class ProcessRegistry;
+class ProcessHistory;
+class LatencyStats;
+class Telemetry;
+class EventTrace;
+class Random;
+
+// One simulated machine: its own settings, scheduler, sim clock, memory and process bookkeeping.
+// getInstance() of each of these returns the instance of the machine entered on the calling
+// thread, or the process-wide one outside any machine, so the console keeps its singletons while
+// a sweep runs many machines side by side. Instances are created on first use and deleted with
+// the machine. Threads the machine starts (clock, executors, page merging) enter it themselves.
+class Machine
+{
+public:
+	Machine() = default;
+	Machine(const Machine&) = delete;
+	Machine& operator=(const Machine&) = delete;
+	~Machine();
+
+	void enter();
+	static void leave();
+	static Machine* current();
+
+	// The instance getInstance() reads and initialize() replaces on this thread
+	template <typename T>
+	static T*& slot(T* Machine::* member, T*& global) {
+		return active != nullptr ? active->*member : global;
+	}
+
+	ConsoleManager* consoleManager = nullptr;
+	Scheduler* scheduler = nullptr;
+	TimerWheel* timerWheel = nullptr;
+	FlatMemoryAllocator* flatMemoryAllocator = nullptr;
+	PagingAllocator* pagingAllocator = nullptr;
+	SwapPool* swapPool = nullptr;
+	ProcessTable* processTable = nullptr;
+	ProcessRegistry* processRegistry = nullptr;
+	ProcessHistory* processHistory = nullptr;
+	LatencyStats* latencyStats = nullptr;
+	Telemetry* telemetry = nullptr;
+	EventTrace* eventTrace = nullptr;
+	Random* random = nullptr;
+
+private:
+	static thread_local Machine* active;
+};
@@ -0,0 +1,78 @@
+#include <algorithm>
+
+#include "ObjectPool.h"
+
+using namespace std;
+
+// Created on first use; a function-local static is initialised once even when sweep machines race to it
+ObjectPool* ObjectPool::getInstance() {
+	static ObjectPool* objectPool = new ObjectPool();
+	return objectPool;
+}
+
+// Pop a block of the size's free list, refilling it with a new chunk when empty
+void* ObjectPool::allocate(size_t size) {
+	size_t blockSize = (std::max(size, sizeof(FreeBlock)) + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1);
+
+	std::lock_guard<std::mutex> lock(poolMutex);
+	numAllocations++;
+	numLive++;
+
+	FreeBlock*& freeList = freeLists[blockSize];
+	if (freeList) {
+		numReused++;
+	}
+	else {
+		chunks.push_back(std::make_unique<char[]>(blockSize * BLOCKS_PER_CHUNK));
+		pooledBytes += blockSize * BLOCKS_PER_CHUNK;
+
+		char* chunk = chunks.back().get();
+		for (size_t i = BLOCKS_PER_CHUNK; i > 0; i--) {
+			FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * blockSize);
+			block->next = freeList;
+			freeList = block;
+		}
+	}
+
+	FreeBlock* block = freeList;
+	freeList = block->next;
+	return block;
+}
+
+void ObjectPool::deallocate(void* block, size_t size) {
+	size_t blockSize = (std::max(size, sizeof(FreeBlock)) + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1);
+
+	std::lock_guard<std::mutex> lock(poolMutex);
+	FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+	FreeBlock*& freeList = freeLists[blockSize];
+	freeBlock->next = freeList;
+	freeList = freeBlock;
+	numLive--;
+}
+
+size_t ObjectPool::getNumAllocations() {
+	std::lock_guard<std::mutex> lock(poolMutex);
+	return numAllocations;
+}
+
+// Allocations served from a free list without carving a new chunk
+size_t ObjectPool::getNumReused() {
+	std::lock_guard<std::mutex> lock(poolMutex);
+	return numReused;
+}
+
+// Heap allocations made by the pool itself
+size_t ObjectPool::getNumChunks() {
+	std::lock_guard<std::mutex> lock(poolMutex);
+	return chunks.size();
+}
+
+size_t ObjectPool::getNumLive() {
+	std::lock_guard<std::mutex> lock(poolMutex);
+	return numLive;
+}
+
+size_t ObjectPool::getPooledBytes() {
+	std::lock_guard<std::mutex> lock(poolMutex);
+	return pooledBytes;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+
+// Free-list pool for objects that are created and destroyed in large numbers
+// (processes and their coroutine frames). Blocks are carved out of large chunks and
+// returned to a per-size free list when released, so steady-state creation does not touch the heap.
+// Unlike the other singletons the pool is not per machine: a block can be freed on a thread that
+// never entered the machine that allocated it, so every machine shares the one pool behind its mutex.
+class ObjectPool
+{
+public:
+	static const size_t BLOCKS_PER_CHUNK = 256;
+	static const size_t BLOCK_ALIGNMENT = alignof(std::max_align_t);
+
+	static ObjectPool* getInstance();
+
+	void* allocate(size_t size);
+	void deallocate(void* block, size_t size);
+
+	size_t getNumAllocations();
+	size_t getNumReused();
+	size_t getNumChunks();
+	size_t getNumLive();
+	size_t getPooledBytes();
+
+private:
+	struct FreeBlock
+	{
+		FreeBlock* next;
+	};
+
+	std::unordered_map<size_t, FreeBlock*> freeLists; // Block size to its free list
+	std::vector<std::unique_ptr<char[]>> chunks;
+	size_t pooledBytes = 0;
+	size_t numAllocations = 0;
+	size_t numReused = 0;
+	size_t numLive = 0;
+	std::mutex poolMutex;
+};
+
+// Standard allocator over the pool, for std::allocate_shared
+template <typename T>
+class PoolAllocator
+{
+public:
+	using value_type = T;
+
+	PoolAllocator() = default;
+	template <typename U>
+	PoolAllocator(const PoolAllocator<U>&) {}
+
+	T* allocate(size_t n) {
+		return static_cast<T*>(ObjectPool::getInstance()->allocate(n * sizeof(T)));
+	}
+
+	void deallocate(T* block, size_t n) {
+		ObjectPool::getInstance()->deallocate(block, n * sizeof(T));
+	}
+
+	template <typename U>
+	bool operator==(const PoolAllocator<U>&) const { return true; }
+	template <typename U>
+	bool operator!=(const PoolAllocator<U>&) const { return false; }
+};
+
+// make_shared with the object and its control block in one pooled block
+template <typename T, typename... Args>
+std::shared_ptr<T> makePooled(Args&&... args) {
+	return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
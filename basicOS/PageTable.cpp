@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "PageTable.h"
+
+using namespace std;
+
+PageTable::PageTable(size_t numVirtualPages, int levels) : numVirtualPages(numVirtualPages), levels(std::clamp(levels, 1, 3))
+{
+	// Split the page number bits evenly across the levels
+	int pageBits = 0;
+	while ((size_t(1) << pageBits) < numVirtualPages) {
+		pageBits++;
+	}
+
+	bitsPerLevel = std::max(1, (pageBits + this->levels - 1) / this->levels);
+	entriesPerNode = size_t(1) << bitsPerLevel;
+
+	// A flat table is sized to the virtual address space up front
+	if (this->levels == 1) {
+		entriesPerNode = std::max<size_t>(numVirtualPages, 1);
+	}
+
+	root = createNode(this->levels == 1);
+}
+
+std::unique_ptr<PageTable::Node> PageTable::createNode(bool leaf) {
+	std::unique_ptr<Node> node = std::make_unique<Node>();
+
+	if (leaf) {
+		node->frames = std::make_unique<size_t[]>(entriesPerNode);
+		std::fill_n(node->frames.get(), entriesPerNode, INVALID_FRAME);
+		hostMemory += sizeof(Node) + entriesPerNode * sizeof(size_t);
+	}
+	else {
+		node->children = std::make_unique<std::unique_ptr<Node>[]>(entriesPerNode);
+		hostMemory += sizeof(Node) + entriesPerNode * sizeof(std::unique_ptr<Node>);
+	}
+	return node;
+}
+
+// Walk the levels down to the leaf entry; returns INVALID_FRAME for unmapped pages
+size_t PageTable::translate(size_t page) const {
+	if (page >= numVirtualPages) {
+		return INVALID_FRAME;
+	}
+
+	const Node* node = root.get();
+	for (int level = levels - 1; level > 0; level--) {
+		size_t index = (page >> (level * bitsPerLevel)) & (entriesPerNode - 1);
+		node = node->children[index].get();
+		if (!node) {
+			return INVALID_FRAME;
+		}
+	}
+
+	return node->frames[levels == 1 ? page : page & (entriesPerNode - 1)];
+}
+
+void PageTable::map(size_t page, size_t frame) {
+	if (page >= numVirtualPages) {
+		throw std::out_of_range("Page is outside the virtual address space.");
+	}
+
+	Node* node = root.get();
+	for (int level = levels - 1; level > 0; level--) {
+		size_t index = (page >> (level * bitsPerLevel)) & (entriesPerNode - 1);
+		if (!node->children[index]) {
+			node->children[index] = createNode(level == 1);
+		}
+		node = node->children[index].get();
+	}
+
+	size_t& entry = node->frames[levels == 1 ? page : page & (entriesPerNode - 1)];
+	if (entry == INVALID_FRAME) {
+		numMapped++;
+	}
+	entry = frame;
+}
+
+void PageTable::unmap(size_t page) {
+	if (page >= numVirtualPages) {
+		return;
+	}
+
+	Node* node = root.get();
+	for (int level = levels - 1; level > 0; level--) {
+		size_t index = (page >> (level * bitsPerLevel)) & (entriesPerNode - 1);
+		node = node->children[index].get();
+		if (!node) {
+			return;
+		}
+	}
+
+	size_t& entry = node->frames[levels == 1 ? page : page & (entriesPerNode - 1)];
+	if (entry != INVALID_FRAME) {
+		numMapped--;
+		entry = INVALID_FRAME;
+	}
+}
+
+// Visit every mapped page; the visitor may remap the page by assigning to frame
+void PageTable::forEachMapped(const std::function<void(size_t page, size_t& frame)>& visit) {
+	forEachMapped(root.get(), levels - 1, 0, visit);
+}
+
+void PageTable::forEachMapped(Node* node, int level, size_t basePage, const std::function<void(size_t, size_t&)>& visit) {
+	if (level == 0) {
+		size_t numEntries = std::min(entriesPerNode, numVirtualPages - basePage);
+		for (size_t i = 0; i < numEntries; i++) {
+			if (node->frames[i] != INVALID_FRAME) {
+				visit(basePage + i, node->frames[i]);
+			}
+		}
+		return;
+	}
+
+	for (size_t i = 0; i < entriesPerNode; i++) {
+		if (node->children[i]) {
+			forEachMapped(node->children[i].get(), level - 1, basePage + (i << (level * bitsPerLevel)), visit);
+		}
+	}
+}
+
+size_t PageTable::getNumVirtualPages() const {
+	return numVirtualPages;
+}
+
+size_t PageTable::getNumMapped() const {
+	return numMapped;
+}
+
+// Host bytes used by the table itself
+size_t PageTable::getHostMemory() const {
+	return hostMemory;
+}
+
+int PageTable::getLevels() const {
+	return levels;
+}
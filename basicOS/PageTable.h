@@ -0,0 +1,44 @@
+#pragma once
+
+#include <memory>
+#include <functional>
+#include <cstdint>
+
+// Maps the virtual pages of one process to physical frames.
+// With one level the table is a flat array covering the whole virtual address space;
+// with two or three levels the lower tables are only allocated once a page inside them is mapped.
+class PageTable
+{
+public:
+	static constexpr size_t INVALID_FRAME = SIZE_MAX;
+
+	PageTable(size_t numVirtualPages, int levels);
+
+	size_t translate(size_t page) const;
+	void map(size_t page, size_t frame);
+	void unmap(size_t page);
+	void forEachMapped(const std::function<void(size_t page, size_t& frame)>& visit);
+
+	size_t getNumVirtualPages() const;
+	size_t getNumMapped() const;
+	size_t getHostMemory() const;
+	int getLevels() const;
+
+private:
+	struct Node
+	{
+		std::unique_ptr<std::unique_ptr<Node>[]> children;
+		std::unique_ptr<size_t[]> frames;
+	};
+
+	std::unique_ptr<Node> createNode(bool leaf);
+	void forEachMapped(Node* node, int level, size_t basePage, const std::function<void(size_t, size_t&)>& visit);
+
+	size_t numVirtualPages;
+	int levels;
+	int bitsPerLevel;
+	size_t entriesPerNode;
+	size_t numMapped = 0;
+	size_t hostMemory = 0;
+	std::unique_ptr<Node> root;
+};
@@ -1,6 +1,10 @@
 #include "PagingAllocator.h"
 #include "ConsoleManager.h"
 #include "Process.h"
+#include "SwapPool.h"
+#include "ProcessTable.h"
+#include "Profiler.h"
+#include "Machine.h"
 
 #include <map>
 #include <vector> 
@@ -9,12 +13,25 @@
 #include <algorithm>
 #include <iostream> 
 #include <set>
+#include <thread>
+#include <chrono>
 
 using namespace std;
 
 PagingAllocator::PagingAllocator(size_t maxMemorySize) : maxMemorySize(maxMemorySize), numFrames(ConsoleManager::getInstance()->getMaxOverallMem() / ConsoleManager::getInstance()->getMemPerFrame())
 {
 	this->maxMemorySize = maxMemorySize;
+	this->frameSize = ConsoleManager::getInstance()->getMemPerFrame();
+	this->pageTableLevels = ConsoleManager::getInstance()->getPageTableLevels();
+
+	// Each process gets a virtual address space of virtual-mem-per-proc, at least large enough for its pages
+	size_t virtualMemory = std::max(ConsoleManager::getInstance()->getVirtualMemPerProc(), ConsoleManager::getInstance()->getMaxMemPerProc());
+	this->numVirtualPages = (virtualMemory + frameSize - 1) / frameSize;
+
+	// Initialize frame contents with '.' like the flat memory
+	frameData.resize(numFrames * frameSize, '.');
+	frameRefCount.resize(numFrames, 0);
+	frameMap.resize(numFrames, ProcessTable::NO_PID);
 
 	// Initialize free frame list
 	for (size_t i = 0; i < numFrames; ++i) {
@@ -22,25 +39,30 @@ PagingAllocator::PagingAllocator(size_t maxMemorySize) : maxMemorySize(maxMemory
 	}
 }
 
+PagingAllocator::~PagingAllocator() {
+	stopPageMerging();
+}
+
 PagingAllocator* PagingAllocator::pagingAllocator = nullptr;
 
 void PagingAllocator::initialize(size_t maxMemorySize) {
-	pagingAllocator = new PagingAllocator(maxMemorySize);
+	Machine::slot(&Machine::pagingAllocator, pagingAllocator) = new PagingAllocator(maxMemorySize);
 }
 
 PagingAllocator* PagingAllocator::getInstance() {
-	return pagingAllocator;
+	return Machine::slot(&Machine::pagingAllocator, pagingAllocator);
 }
 
 
-std::mutex allocationMap2Mutex;
-
 bool PagingAllocator::allocate(std::shared_ptr<Process> process) {
+	PROFILE_ZONE(PAGING_ALLOCATE);
 	{
 		std::lock_guard<std::mutex> lock(allocationMap2Mutex);
 
-		string processId = process->getProcessName();
-		size_t numFramesNeeded = process->getNumPages();
+		int pid = process->getPid();
+
+		// The symbol table is always mapped, however little memory the process asked for
+		size_t numFramesNeeded = std::max(process->getNumPages(), (ExecutionState::SYMBOL_TABLE_SIZE + frameSize - 1) / frameSize);
 
 
 		if (numFramesNeeded > freeFrameList.size()) {
@@ -48,57 +70,70 @@ bool PagingAllocator::allocate(std::shared_ptr<Process> process) {
 			return false;
 		}
 
-		size_t frameIndex = allocateFrames(numFramesNeeded, processId);
+		allocateFrames(numFramesNeeded, pid);
+
+		// Bring back the pages of a process that was swapped out
+		if (SwapPool::getInstance()->contains(pid)) {
+			std::vector<char> image(numFramesNeeded * frameSize);
+			if (SwapPool::getInstance()->swapIn(pid, image.data(), image.size()) != SwapPool::NONE) {
+				size_t offset = 0;
+				pageTables.at(pid).forEachMapped([&](size_t, size_t& frame) {
+					std::copy_n(image.begin() + offset, frameSize, frameData.begin() + frame * frameSize);
+					offset += frameSize;
+					});
+			}
+			std::erase_if(backingStore, [pid](const std::shared_ptr<Process>& stored) {
+				return stored->getPid() == pid;
+				});
+		}
 		process->setMemoryUsage(process->getMemoryRequired());
 		process->setIsRunning(true);
-		processMemoryMap[process->getProcessName()] += process->getMemoryRequired();
+		processMemoryMap[pid] += process->getMemoryRequired();
 
-		allocationMap.push(process);
+		allocationMap.push_back(process);
 		return true;
 	}
 }
 
 void PagingAllocator::deallocate(std::shared_ptr<Process> process) {
-	string processName = process->getProcessName();
+	PROFILE_ZONE(PAGING_DEALLOCATE);
+	std::lock_guard<std::mutex> lock(allocationMap2Mutex);
+	deallocateLocked(process);
+}
 
-	auto it = std::find_if(frameMap.begin(), frameMap.end(),
-		[&processName](const std::pair<const size_t, std::string>& entry) {
-			return entry.second == processName;
-		});
+void PagingAllocator::deallocateLocked(std::shared_ptr<Process> process) {
+	int pid = process->getPid();
+
+	auto it = pageTables.find(pid);
+	if (it != pageTables.end()) {
+		// Release every page; frames shared with other processes stay resident
+		it->second.forEachMapped([this, pid](size_t, size_t& frameIndex) {
+			deallocateFrames(1, frameIndex, pid);
+			});
+		pageTables.erase(it);
 
-	while (it != frameMap.end()) {
-		size_t frameIndex = it->first;
-		deallocateFrames(1, frameIndex);
-		it = std::find_if(frameMap.begin(), frameMap.end(),
-			[processName](const auto& entry) { return entry.second == processName; });
 		// Deduct from process memory usage
-		if (processMemoryMap.find(process->getProcessName()) != processMemoryMap.end()) {
-			processMemoryMap[process->getProcessName()] -= process->getMemoryRequired();
+		auto usage = processMemoryMap.find(pid);
+		if (usage != processMemoryMap.end()) {
+			usage->second -= process->getMemoryRequired();
 			process->setMemoryUsage(0);
-			if (processMemoryMap[process->getProcessName()] == 0) {
-				processMemoryMap.erase(process->getProcessName());
+			if (usage->second == 0) {
+				processMemoryMap.erase(usage);
 			}
 		}
-
-
-	}
-	{
-		std::lock_guard<std::mutex> lock(allocationMap2Mutex);
-		allocationMap.pop();
 	}
+
+	std::erase(allocationMap, process);
 }
 
-bool PagingAllocator::isProcessInMemory(const std::string& processName) {
-	for (const auto& frame : frameMap) {
-		if (frame.second == processName) {
-			return true;
-		}
-	}
-	return false;
+bool PagingAllocator::isProcessInMemory(int pid) {
+	std::lock_guard<std::mutex> lock(allocationMap2Mutex);
+	return pageTables.contains(pid);
 }
 
 
 void PagingAllocator::visualizeBackingStore() {
+	std::lock_guard<std::mutex> lock(allocationMap2Mutex);
 	if (backingStore.empty()) {
 		std::cout << "Backing store is empty." << std::endl;
 		return;
@@ -131,56 +166,337 @@ void PagingAllocator::visualizeMemory()
 }
 
 size_t PagingAllocator::calculateUsedFrames() {
-	size_t usedFrames = 0; 
-
-	// Iterate through frameMap to count allocated frames
-	for (const auto& frame : frameMap)
-	{
-		if (!frame.second.empty()) 
-		{
-			++usedFrames;
-		}
-	}
+	std::lock_guard<std::mutex> lock(allocationMap2Mutex);
+	return numFrames - freeFrameList.size();
+}
 
-	return usedFrames;
+size_t PagingAllocator::getNumFreeFrames() {
+	std::lock_guard<std::mutex> lock(allocationMap2Mutex);
+	return freeFrameList.size();
 }
 
-size_t PagingAllocator::allocateFrames(size_t numFrames, string processName) {
+size_t PagingAllocator::allocateFrames(size_t numFrames, int pid) {
+	PageTable& pageTable = pageTables.try_emplace(pid, numVirtualPages, pageTableLevels).first->second;
 	size_t frameIndex = freeFrameList.back();
+	size_t bottomPages = std::min(numFrames, std::max((numFrames + 1) / 2, (ExecutionState::SYMBOL_TABLE_SIZE + frameSize - 1) / frameSize));
 
 	for (size_t i = 0; i < numFrames; ++i) {
-		frameMap[frameIndex + i] = processName;
+		size_t frame = freeFrameList.back();
 		freeFrameList.pop_back();
+
+		frameMap[frame] = pid;
+		frameRefCount[frame] = 1;
+		std::fill_n(frameData.begin() + frame * frameSize, frameSize, '.');
+
+		// Lower half of the pages at the bottom of the address space, upper half at the top;
+		// the pages holding the symbol table are always at the bottom
+		size_t page = i < bottomPages ? i : numVirtualPages - (numFrames - i);
+		pageTable.map(page, frame);
 	}
 	numPagedIn += numFrames;
 	return frameIndex;
 
 }
 
-void PagingAllocator::deallocateFrames(size_t numFrames, size_t frameIndex) {
+// Drop the process's reference to the frames; only frames nobody else shares are paged out
+void PagingAllocator::deallocateFrames(size_t numFrames, size_t frameIndex, int pid) {
 	for (size_t i = 0; i < numFrames; ++i) {
-		frameMap.erase(frameIndex + i);
+		size_t frame = frameIndex + i;
+		if (frameRefCount[frame] == 0) {
+			continue;
+		}
+		if (--frameRefCount[frame] == 0) {
+			releaseFrame(frame);
+			numPagedOut++;
+		}
+		else if (frameMap[frame] == pid) {
+			reassignOwner(frame, pid);
+		}
 	}
+}
 
-	for (size_t i = 0; i < numFrames; ++i) {
-		freeFrameList.push_back(frameIndex + i);
+// Hand a shared frame the owner is leaving to another process still mapping it
+void PagingAllocator::reassignOwner(size_t frameIndex, int leavingPid) {
+	frameMap[frameIndex] = ProcessTable::NO_PID;
+	for (auto& pageTable : pageTables) {
+		if (pageTable.first == leavingPid) {
+			continue;
+		}
+		pageTable.second.forEachMapped([&](size_t, size_t& frame) {
+			if (frame == frameIndex) {
+				frameMap[frameIndex] = pageTable.first;
+			}
+			});
+		if (frameMap[frameIndex] != ProcessTable::NO_PID) {
+			return;
+		}
+	}
+}
+
+// Return a frame nobody references anymore to the free list
+void PagingAllocator::releaseFrame(size_t frameIndex) {
+	frameMap[frameIndex] = ProcessTable::NO_PID;
+	freeFrameList.push_back(frameIndex);
+}
+
+// Read bytes from a process's virtual memory through its page table
+bool PagingAllocator::read(int pid, size_t address, char* data, size_t size) {
+	std::lock_guard<std::mutex> lock(allocationMap2Mutex);
+
+	auto it = pageTables.find(pid);
+	if (it == pageTables.end()) {
+		return false;
+	}
+
+	for (size_t i = 0; i < size; i++) {
+		size_t frame = it->second.translate((address + i) / frameSize);
+		if (frame == PageTable::INVALID_FRAME) {
+			return false;
+		}
+		data[i] = frameData[frame * frameSize + (address + i) % frameSize];
+	}
+	return true;
+}
+
+// Write bytes to a process's virtual memory, breaking sharing first if a frame is merged.
+// Fails with a page fault when a copy-on-write needs a frame and none is free.
+PagingAllocator::WriteResult PagingAllocator::write(int pid, size_t address, const char* data, size_t size) {
+	std::lock_guard<std::mutex> lock(allocationMap2Mutex);
+
+	auto it = pageTables.find(pid);
+	if (it == pageTables.end()) {
+		return UNMAPPED;
+	}
+
+	for (size_t i = 0; i < size; i++) {
+		size_t page = (address + i) / frameSize;
+		size_t frame = it->second.translate(page);
+		if (frame == PageTable::INVALID_FRAME) {
+			return UNMAPPED;
+		}
+
+		if (frameRefCount[frame] > 1) {
+			// Copy-on-write: the writer gets a private copy of the shared frame
+			if (freeFrameList.empty()) {
+				numPageFaults++;
+				return NO_FREE_FRAME;
+			}
+
+			size_t copy = freeFrameList.back();
+			freeFrameList.pop_back();
+			std::copy_n(frameData.begin() + frame * frameSize, frameSize, frameData.begin() + copy * frameSize);
+
+			frameRefCount[frame]--;
+			frameRefCount[copy] = 1;
+			frameMap[copy] = pid;
+			it->second.map(page, copy);
+			if (frameMap[frame] == pid) {
+				reassignOwner(frame, pid);
+			}
+			frame = copy;
+			numCopyOnWrite++;
+		}
+
+		frameData[frame * frameSize + (address + i) % frameSize] = data[i];
+	}
+	return WRITTEN;
+}
+
+// Free frames by moving the oldest resident process that is not running to the backing store.
+// Returns the PID of the swapped-out process, or NO_PID if every resident process is running.
+int PagingAllocator::swapOutOldest(int exceptPid) {
+	std::shared_ptr<Process> victim;
+	{
+		// Chosen and evicted under one lock, so a process claimed by a dispatch either is
+		// skipped here or finds its pages already gone
+		std::lock_guard<std::mutex> lock(allocationMap2Mutex);
+		for (const auto& process : allocationMap) {
+			if (process->getPid() != exceptPid && process->getState() != Process::RUNNING) {
+				victim = process;
+				break;
+			}
+		}
+
+		if (!victim) {
+			return ProcessTable::NO_PID;
+		}
+
+		swapOutLocked(victim);
+		deallocateLocked(victim);
 	}
-	numPagedOut += numFrames;
+
+	victim->setStateIf(Process::READY, Process::SWAPPED);
+	return victim->getPid();
 }
 
-size_t PagingAllocator::getProcessMemoryUsage(const std::string& processName) {
-	std::cout << "Looking for process: " << processName << std::endl;
-	for (const auto& entry : processMemoryMap) {
-		std::cout << "Process: " << entry.first << ", Memory: " << entry.second << " KB" << std::endl;
+size_t PagingAllocator::getNumPageFaults() const {
+	return numPageFaults;
+}
+
+// FNV-1a hash of a frame's contents
+uint64_t PagingAllocator::hashFrame(size_t frameIndex) const {
+	uint64_t hash = 14695981039346656037ull;
+	const char* data = &frameData[frameIndex * frameSize];
+
+	for (size_t i = 0; i < frameSize; ++i) {
+		hash ^= static_cast<unsigned char>(data[i]);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+// Merge frames with identical contents into one shared, copy-on-write frame.
+// Returns the number of frames given back to the free list.
+size_t PagingAllocator::mergeIdenticalPages() {
+	std::lock_guard<std::mutex> lock(allocationMap2Mutex);
+
+	// Pick one canonical frame for each distinct page content
+	std::unordered_map<uint64_t, std::vector<size_t>> framesByHash;
+	std::vector<size_t> canonicalFrame(numFrames);
+
+	for (size_t frameIndex = 0; frameIndex < numFrames; ++frameIndex) {
+		if (frameMap[frameIndex] == ProcessTable::NO_PID) {
+			continue;
+		}
+		std::vector<size_t>& candidates = framesByHash[hashFrame(frameIndex)];
+
+		canonicalFrame[frameIndex] = frameIndex;
+		for (size_t candidate : candidates) {
+			if (std::equal(frameData.begin() + candidate * frameSize, frameData.begin() + (candidate + 1) * frameSize,
+				frameData.begin() + frameIndex * frameSize)) {
+				canonicalFrame[frameIndex] = candidate;
+				break;
+			}
+		}
+
+		if (canonicalFrame[frameIndex] == frameIndex) {
+			candidates.push_back(frameIndex);
+		}
+	}
+
+	// Point every page at its canonical frame and free the duplicates
+	size_t mergedFrames = 0;
+	for (auto& pageTable : pageTables) {
+		pageTable.second.forEachMapped([&](size_t, size_t& frame) {
+			size_t canonical = canonicalFrame[frame];
+			if (canonical == frame) {
+				return;
+			}
+
+			frameRefCount[canonical]++;
+			if (--frameRefCount[frame] == 0) {
+				releaseFrame(frame);
+				mergedFrames++;
+			}
+			frame = canonical;
+			});
 	}
-	if (processMemoryMap.find(processName) != processMemoryMap.end()) {
-		return processMemoryMap.at(processName);
+
+	// A shared frame keeps its owner only while the owner still maps it; otherwise the
+	// first process found mapping it takes over
+	std::vector<bool> ownerMaps(numFrames, false);
+	for (auto& pageTable : pageTables) {
+		pageTable.second.forEachMapped([&](size_t, size_t& frame) {
+			ownerMaps[frame] = ownerMaps[frame] || frameMap[frame] == pageTable.first;
+			});
 	}
-	else {
-		std::cout << "Process not found!" << std::endl;
+	for (auto& pageTable : pageTables) {
+		pageTable.second.forEachMapped([&](size_t, size_t& frame) {
+			if (!ownerMaps[frame]) {
+				frameMap[frame] = pageTable.first;
+				ownerMaps[frame] = true;
+			}
+			});
 	}
-	return 0;
 
+	return mergedFrames;
+}
+
+// Run the merge scanner in the background every intervalMs milliseconds
+void PagingAllocator::startPageMerging(int intervalMs) {
+	if (intervalMs <= 0 || pageMergeRunning) {
+		return;
+	}
+
+	pageMergeRunning = true;
+	Machine* machine = Machine::current();
+	pageMergeThread = std::thread([this, intervalMs, machine]() {
+		if (machine != nullptr) {
+			machine->enter();
+		}
+
+		// Sleep on the condition so stopPageMerging does not wait out the interval
+		std::unique_lock<std::mutex> lock(pageMergeMutex);
+		while (!pageMergeCondition.wait_for(lock, std::chrono::milliseconds(intervalMs), [this]() { return !pageMergeRunning; })) {
+			lock.unlock();
+			mergeIdenticalPages();
+			lock.lock();
+		}
+		});
+}
+
+void PagingAllocator::stopPageMerging() {
+	{
+		std::lock_guard<std::mutex> lock(pageMergeMutex);
+		pageMergeRunning = false;
+	}
+	pageMergeCondition.notify_all();
+	if (pageMergeThread.joinable()) {
+		pageMergeThread.join();
+	}
+}
+
+// Number of frames referenced by more than one page
+size_t PagingAllocator::getNumSharedFrames() {
+	std::lock_guard<std::mutex> lock(allocationMap2Mutex);
+	return std::count_if(frameRefCount.begin(), frameRefCount.end(), [](size_t refCount) { return refCount > 1; });
+}
+
+// Number of pages that map onto a shared frame
+size_t PagingAllocator::getNumSharingPages() {
+	std::lock_guard<std::mutex> lock(allocationMap2Mutex);
+	size_t sharingPages = 0;
+
+	for (size_t refCount : frameRefCount) {
+		if (refCount > 1) {
+			sharingPages += refCount;
+		}
+	}
+	return sharingPages;
+}
+
+// Memory that would be in use without merging, minus what is in use now
+size_t PagingAllocator::getMemorySavedByMerging() {
+	std::lock_guard<std::mutex> lock(allocationMap2Mutex);
+	size_t mappedPages = 0;
+
+	for (const auto& pageTable : pageTables) {
+		mappedPages += pageTable.second.getNumMapped();
+	}
+	return (mappedPages - (numFrames - freeFrameList.size())) * frameSize;
+}
+
+// Host memory taken by the page tables of all resident processes
+size_t PagingAllocator::getPageTableMemory() {
+	std::lock_guard<std::mutex> lock(allocationMap2Mutex);
+	size_t pageTableMemory = 0;
+
+	for (const auto& pageTable : pageTables) {
+		pageTableMemory += pageTable.second.getHostMemory();
+	}
+	return pageTableMemory;
+}
+
+size_t PagingAllocator::getNumCopyOnWrite() const {
+	return numCopyOnWrite;
+}
+
+size_t PagingAllocator::getProcessMemoryUsage(int pid) {
+	auto it = processMemoryMap.find(pid);
+	if (it != processMemoryMap.end()) {
+		return it->second;
+	}
+	return 0;  // Process not found
 }
 
 size_t PagingAllocator::getUsedMemory()
@@ -192,22 +508,16 @@ void PagingAllocator::setUsedMemory(size_t usedMemory) {
 	this->usedMemory = usedMemory;
 }
 
-std::string PagingAllocator::findOldestProcess() {
-	std::shared_ptr<Process> oldest;
-	{
-		std::lock_guard<std::mutex> lock(allocationMap2Mutex);
-		oldest = allocationMap.front();
-	}
-
-	return oldest->getProcessName();
-
+int PagingAllocator::findOldestProcess() {
+	std::lock_guard<std::mutex> lock(allocationMap2Mutex);
+	return allocationMap.empty() ? ProcessTable::NO_PID : allocationMap.front()->getPid();
 }
 
 void PagingAllocator::findAndRemoveProcessFromBackingStore(std::shared_ptr<Process> process) {
-	bool found = false;
+	std::lock_guard<std::mutex> lock(allocationMap2Mutex);
 
 	for (int i = 0; i < backingStore.size(); i++) {
-		if (backingStore[i]->getProcessName() == process->getProcessName()) {
+		if (backingStore[i]->getPid() == process->getPid()) {
 			// Remove the process from the backing store
 			backingStore.erase(backingStore.begin() + i);
 			break;
@@ -215,7 +525,27 @@ void PagingAllocator::findAndRemoveProcessFromBackingStore(std::shared_ptr<Proce
 	}
 }
 
+// Add a process to the backing store; call before deallocating so its pages can be saved
 void PagingAllocator::allocateFromBackingStore(std::shared_ptr<Process> process) {
+	PROFILE_ZONE(BACKING_STORE);
+	{
+		std::lock_guard<std::mutex> lock(allocationMap2Mutex);
+		swapOutLocked(process);
+	}
+	process->setStateIf(Process::READY, Process::SWAPPED);
+}
+
+// Save the process's pages to the swap pool and list it in the backing store
+void PagingAllocator::swapOutLocked(std::shared_ptr<Process> process) {
+	auto it = pageTables.find(process->getPid());
+	if (it != pageTables.end()) {
+		std::vector<char> image;
+		image.reserve(it->second.getNumMapped() * frameSize);
+		it->second.forEachMapped([&](size_t, size_t& frame) {
+			image.insert(image.end(), frameData.begin() + frame * frameSize, frameData.begin() + (frame + 1) * frameSize);
+			});
+		SwapPool::getInstance()->swapOut(process->getPid(), image.data(), image.size(), frameSize);
+	}
 	backingStore.push_back(process);
 }
 
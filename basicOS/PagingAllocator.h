@@ -3,13 +3,20 @@
 #include <unordered_map>
 #include <map>
 #include <queue>
+#include <deque>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 
 #include "Process.h"
+#include "PageTable.h"
 
 class PagingAllocator
 {
 public:
 	PagingAllocator(size_t maxMemorySize);
+	~PagingAllocator();
 
 	static void initialize(size_t maximumMemorySize);
 
@@ -19,34 +26,79 @@ public:
 	void deallocate(std::shared_ptr<Process> process);
 	void visualizeMemory();
 	size_t calculateUsedFrames();
-	size_t getProcessMemoryUsage(const std::string& processName);
+	size_t getNumFreeFrames();
+	size_t getProcessMemoryUsage(int pid);
 	size_t getUsedMemory();
 	void allocateFromBackingStore(std::shared_ptr<Process> process);
 	void findAndRemoveProcessFromBackingStore(std::shared_ptr<Process> process);
 	void setUsedMemory(size_t usedMemory);
-	std::string findOldestProcess();
-	bool isProcessInMemory(const std::string& processName);
+	int findOldestProcess();
+	bool isProcessInMemory(int pid);
 	void visualizeBackingStore();
 
+	// Page contents, accessed through the process page table
+	bool read(int pid, size_t address, char* data, size_t size);
+	enum WriteResult
+	{
+		WRITTEN,
+		UNMAPPED,		// The address is outside the process's mapped pages
+		NO_FREE_FRAME	// A copy-on-write needs a frame and none is free
+	};
+
+	WriteResult write(int pid, size_t address, const char* data, size_t size);
+	int swapOutOldest(int exceptPid);
+	size_t getNumPageFaults() const;
+
+	// Same-page merging
+	void startPageMerging(int intervalMs);
+	void stopPageMerging();
+	size_t mergeIdenticalPages();
+	size_t getNumSharedFrames();
+	size_t getNumSharingPages();
+	size_t getMemorySavedByMerging();
+	size_t getNumCopyOnWrite() const;
+
+	size_t getPageTableMemory();
+
 	size_t getNumPagedIn() const;
 	size_t getNumPagedOut() const;
 
 private:
 	static PagingAllocator* pagingAllocator;
-	std::map<size_t, std::string> frameMap; // Maps frame index to process name
+	std::vector<int> frameMap; // Owning PID of each frame
 	std::vector<size_t> freeFrameList;
 
 	size_t maxMemorySize;
 	size_t numFrames;
+	size_t frameSize;
+	size_t numVirtualPages;
+	int pageTableLevels;
 	size_t usedMemory = 0;
 
-	size_t allocateFrames(size_t numFrames, string processName);
-	void deallocateFrames(size_t numFrames, size_t frameIndex);
-	std::unordered_map<std::string, size_t> processMemoryMap;
+	size_t allocateFrames(size_t numFrames, int pid);
+	void deallocateLocked(std::shared_ptr<Process> process);
+	void swapOutLocked(std::shared_ptr<Process> process);
+	void deallocateFrames(size_t numFrames, size_t frameIndex, int pid);
+	void reassignOwner(size_t frameIndex, int leavingPid);
+	void releaseFrame(size_t frameIndex);
+	uint64_t hashFrame(size_t frameIndex) const;
+	std::unordered_map<int, size_t> processMemoryMap;
+
+	// Frame contents and the number of page table entries pointing at each frame
+	std::vector<char> frameData;
+	std::vector<size_t> frameRefCount;
+	std::unordered_map<int, PageTable> pageTables; // Maps PID to its page table
 
 	std::vector<shared_ptr<Process>> backingStore;
-	std::queue<shared_ptr<Process>> allocationMap;
+	std::deque<shared_ptr<Process>> allocationMap; // Resident processes, oldest first
+	mutable std::mutex allocationMap2Mutex;
 
 	size_t numPagedIn = 0;
 	size_t numPagedOut = 0;
+	size_t numCopyOnWrite = 0;
+	size_t numPageFaults = 0;
+	std::atomic<bool> pageMergeRunning = false;
+	std::thread pageMergeThread;
+	std::mutex pageMergeMutex;
+	std::condition_variable pageMergeCondition;
 };
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdio>
+#include <ctime>
+#include <cerrno>
+
+// The emulator is written against MSVC; these stand in for its CRT extensions
+// so the same sources build with GCC and Clang (see CMakeLists.txt).
+#ifdef _WIN32
+#define CLEAR_SCREEN_COMMAND "cls"
+#else
+#define CLEAR_SCREEN_COMMAND "clear"
+
+typedef int errno_t;
+
+inline errno_t fopen_s(FILE** file, const char* fileName, const char* mode) {
+	*file = std::fopen(fileName, mode);
+	return *file ? 0 : errno;
+}
+
+inline errno_t localtime_s(std::tm* result, const std::time_t* time) {
+	return localtime_r(time, result) ? 0 : errno;
+}
+#endif
@@ -2,15 +2,16 @@
 
 #include "PrintCommand.h"
 
-PrintCommand::PrintCommand(int pid, std::string text) : Instruction(pid, CommandType::PRINT)
+PrintCommand::PrintCommand(int pid, const std::string& processName, int line) : Instruction(pid, CommandType::PRINT)
 {
-	this->toPrint = text;
+	this->processName = &processName;
+	this->line = line;
 }
 
 void PrintCommand::execute()
 {
 	Instruction::execute();
 
-	std::cout << "PID: " << pid << "  Log: " << toPrint;
+	std::cout << "PID: " << pid << "  Log: " << "Printing from " << *processName << " " << line;
 
 }
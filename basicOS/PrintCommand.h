@@ -7,10 +7,12 @@
 class PrintCommand : public Instruction
 {
 public:
-	PrintCommand(int pid, std::string text);
+	PrintCommand(int pid, const std::string& processName, int line);
 	void execute() override;
 
 private:
-	std::string toPrint;
+	// The text is only formatted when the command is executed
+	const std::string* processName;
+	int line;
 };
 
@@ -4,105 +4,107 @@
 #include <thread>
 #include <chrono>
 #include <fstream>
-#include <random>
+#include <cstring>
 
 #include "Process.h"
 #include "PrintCommand.h"
 #include "ConsoleManager.h"
+#include "ProcessTable.h"
+#include "PagingAllocator.h"
+#include "EventTrace.h"
+#include "Random.h"
 
 using namespace std;
 
-Process::Process(string processName, int currentLine, string timestamp, size_t memoryRequired)
-    : ProcessScreen(processName), cpuCoreID(-1), commandCounter(0), currentState(ProcessState::READY)
+Process::Process(string processName, int currentLine, time_t timestamp, size_t memoryRequired)
+    : ProcessScreen(), commandCounter(0)
 {
-    this->processName = processName;
-    this->currentLine = currentLine;
+	this->pid = ProcessTable::getInstance()->create(processName, timestamp, 0);
+    this->setCurrentLine(currentLine);
 	this->setRandomIns();
 	this->memoryRequired = memoryRequired;
-    this->timestamp = timestamp;
 
 	this->numPages = ConsoleManager::getInstance()->getNumPages();
+	this->ioFrequency = ConsoleManager::getInstance()->getIoFrequency();
 
-	// 100 print commands
-	for(int i=0; i<totalLine; i++){
-		this->printCommands.push_back(PrintCommand(i, "Printing from " + processName + " " + std::to_string(i)));
-
-	}
+	// Keyed by creation order, since a reused PID would repeat an earlier process's program
+	this->seed = static_cast<uint32_t>(Random::getInstance()->get(Random::PROGRAM, ProcessTable::getInstance()->serial(pid)));
 }
 
 void Process::setMemoryUsage(size_t memoryUsage)
 {
-	this->memoryUsage = memoryUsage;
+	ProcessTable::getInstance()->memoryUsage(pid) = static_cast<uint32_t>(memoryUsage);
 }
 
 size_t Process::getMemoryUsage() const
 {
-	return this->memoryUsage;
+	return ProcessTable::getInstance()->memoryUsage(pid);
 }
 
 void Process::setIsRunning(bool isRunning)
 {
-	this->isRunning = isRunning;
+	ProcessTable::getInstance()->isRunning(pid) = isRunning;
 }
 
 bool Process::getIsRunning() const
 {
-	return this->isRunning;
+	return ProcessTable::getInstance()->isRunning(pid);
 }
 
 void Process::setRandomIns() {
-	std::random_device rd;
-	std::mt19937 gen(rd()); 
-	std::uniform_int_distribution<> dis(ConsoleManager::getInstance()->getMinIns(), ConsoleManager::getInstance()->getMaxIns()); 
-	this->totalLine = dis(gen);
+	this->setTotalLine(Random::getInstance()->uniform(Random::INSTRUCTIONS, ProcessTable::getInstance()->serial(pid), ConsoleManager::getInstance()->getMinIns(), ConsoleManager::getInstance()->getMaxIns()));
 }
 
+// The PID goes back to the table for the next process
 Process::~Process()
 {
+	ProcessTable::getInstance()->release(pid);
 }
 
-void Process::setProcessName(string processName)
+void Process::setCurrentLine(int currentLine)
 {
-	this->processName = processName;
+	ProcessTable::getInstance()->currentLine(pid) = currentLine;
 }
 
-void Process::setCurrentLine(int currentLine)
+void Process::setTotalLine(int totalLine)
 {
-	this->currentLine = currentLine;
+	ProcessTable::getInstance()->totalLine(pid) = totalLine;
 }
 
-void Process::setTotalLine(int totalLine)
+void Process::setTimestamp(time_t timestamp)
 {
-	this->totalLine = totalLine;
+	ProcessTable::getInstance()->created(pid) = timestamp;
 }
 
-void Process::setTimestamp(string timestamp)
+string Process::getConsoleName()
 {
-	this->timestamp = timestamp;
+	return ProcessTable::getInstance()->name(pid);
 }
 
 string Process::getProcessName()
 {
-	return this->processName;
+	return ProcessTable::getInstance()->name(pid);
 }
 
 int Process::getCurrentLine()
 {
-	return this->currentLine;
+	return ProcessTable::getInstance()->currentLine(pid);
 }
 
 int Process::getTotalLine()
 {
-	return this->totalLine;
+	return ProcessTable::getInstance()->totalLine(pid);
 }
 
+// Timestamps are kept as time_t and only formatted for display
 string Process::getTimestamp()
 {
-	return this->timestamp;
+	return ConsoleManager::getInstance()->formatTimestamp(ProcessTable::getInstance()->created(pid));
 }
 
 string Process::getTimestampFinished() {
-	return timestampFinished;
+	time_t finished = ProcessTable::getInstance()->finished(pid);
+	return finished == 0 ? string() : ConsoleManager::getInstance()->formatTimestamp(finished);
 }
 
 size_t Process::getNumPages()
@@ -115,24 +117,32 @@ void Process::setNumPages(size_t numPages)
 	this->numPages = numPages;
 }
 
-void Process::setTimestampFinished(string timestampFinished) {
-	this->timestampFinished = timestampFinished;
+// Percentage of IO instructions; must be set before the program is generated on first dispatch
+void Process::setIoFrequency(int ioFrequency)
+{
+	this->ioFrequency = ioFrequency;
+}
+
+void Process::setTimestampFinished(time_t timestampFinished) {
+	ProcessTable::getInstance()->finished(pid) = timestampFinished;
 }
 
 
 void Process::executeCurrentCommand()
 {
-	this->printCommands[this->currentLine].execute();
+	// Instructions are generated from the program counter when they run, not stored
+	PrintCommand command(pid, ProcessTable::getInstance()->name(pid), this->getCurrentLine());
+	command.execute();
 }
 
 void Process::moveToNextLine()
 {
-	this->currentLine++;
+	ProcessTable::getInstance()->currentLine(pid)++;
 }
 
 bool Process::isFinished() const
 {
-	return this->currentLine >= this->totalLine;
+	return ProcessTable::getInstance()->currentLine(pid) >= ProcessTable::getInstance()->totalLine(pid);
 }
 
 int Process::getCommandCounter() const
@@ -142,32 +152,140 @@ int Process::getCommandCounter() const
 
 int Process::getCPUCoreID() const
 {
-	return this->cpuCoreID;
+	return ProcessTable::getInstance()->core(pid);
+}
+
+int Process::getPid() const
+{
+	return this->pid;
+}
+
+// The program is compiled on first use, so queued processes cost no bytecode
+ExecutionState& Process::getExecutionState()
+{
+	if (this->executionState.program.empty() && !this->isFinished()) {
+		this->executionState.program = ProgramGenerator::generate(this->seed, this->getTotalLine(), this->ioFrequency);
+		this->executionState.memory = this;
+	}
+	return this->executionState;
+}
+
+// Free the bytecode of a finished process; it is never generated again
+void Process::releaseProgram()
+{
+	std::vector<Bytecode>().swap(this->executionState.program);
+}
+
+void Process::setMemoryPtr(void* memoryPtr)
+{
+	this->memoryPtr = static_cast<char*>(memoryPtr);
+}
+
+// The symbol table holds one 16-bit little-endian variable per slot from address 0 of the process memory
+bool Process::readVariable(int slot, uint16_t& value)
+{
+	size_t address = slot * sizeof(uint16_t);
+	unsigned char bytes[2];
+
+	if (ConsoleManager::getInstance()->getMinMemPerProc() == ConsoleManager::getInstance()->getMaxMemPerProc()) {
+		if (!this->memoryPtr || address + sizeof(bytes) > this->memoryRequired) {
+			return false;
+		}
+		memcpy(bytes, this->memoryPtr + address, sizeof(bytes));
+	}
+	else if (!PagingAllocator::getInstance()->read(this->getPid(), address, reinterpret_cast<char*>(bytes), sizeof(bytes))) {
+		return false;
+	}
+
+	value = static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+	return true;
+}
+
+bool Process::writeVariable(int slot, uint16_t value)
+{
+	size_t address = slot * sizeof(uint16_t);
+	char bytes[2] = { static_cast<char>(value & 0xFF), static_cast<char>(value >> 8) };
+
+	if (ConsoleManager::getInstance()->getMinMemPerProc() == ConsoleManager::getInstance()->getMaxMemPerProc()) {
+		if (!this->memoryPtr || address + sizeof(bytes) > this->memoryRequired) {
+			return false;
+		}
+		memcpy(this->memoryPtr + address, bytes, sizeof(bytes));
+		return true;
+	}
+
+	PagingAllocator::WriteResult result = PagingAllocator::getInstance()->write(this->getPid(), address, bytes, sizeof(bytes));
+	if (result != PagingAllocator::NO_FREE_FRAME) {
+		return result == PagingAllocator::WRITTEN;
+	}
+
+	// Page fault with no free frame: swap another process out and retry
+	int victim = PagingAllocator::getInstance()->swapOutOldest(this->getPid());
+	if (victim == ProcessTable::NO_PID) {
+		return false;
+	}
+	EventTrace::getInstance()->record(this->getCPUCoreID(), EventTrace::SWAP_OUT, victim);
+	return PagingAllocator::getInstance()->write(this->getPid(), address, bytes, sizeof(bytes)) == PagingAllocator::WRITTEN;
+}
+
+TimerWheel::Timer& Process::getWakeupTimer() {
+	return this->wakeupTimer;
+}
+
+ProcessTask& Process::getTask() {
+	return this->task;
+}
+
+void Process::setTask(ProcessTask task) {
+	this->task = std::move(task);
+}
+
+// Last PRINT outputs, oldest first
+std::vector<ExecutionState::LogEntry> Process::getRecentLogs() const
+{
+	std::vector<ExecutionState::LogEntry> logs;
+	int first = std::max(0, this->executionState.numLogs - ExecutionState::LOG_SIZE);
+
+	for (int i = first; i < this->executionState.numLogs; i++) {
+		logs.push_back(this->executionState.logs[i % ExecutionState::LOG_SIZE]);
+	}
+	return logs;
 }
 
 Process::ProcessState Process::getState() const
 {
-	return this->currentState;
+	return static_cast<ProcessState>(ProcessTable::getInstance()->state(pid));
+}
+
+void Process::setState(ProcessState state)
+{
+	ProcessTable::getInstance()->setState(pid, static_cast<uint8_t>(state));
+}
+
+bool Process::setStateIf(ProcessState expected, ProcessState state)
+{
+	return ProcessTable::getInstance()->setStateIf(pid, static_cast<uint8_t>(expected), static_cast<uint8_t>(state));
 }
 
 void Process::setCPUCoreID(int coreID)
 {
-	this->cpuCoreID = coreID;
+	ProcessTable::getInstance()->core(pid) = static_cast<int16_t>(coreID);
 }
 
-void Process::createFile()
+// Static, so an archived process whose object is gone can still be printed
+void Process::createFile(const string& processName)
 {
-	string fileName = this->processName + ".txt";
+	string fileName = processName + ".txt";
 	fstream file;
 	//create file if it doesnt exit
 	file.open(fileName, std::ios::out | std::ios::trunc);
-	file << "Hello world from "<< this->processName << "!" << std::endl;
+	file << "Hello world from "<< processName << "!" << std::endl;
 	file.close();
 }
 
-void Process::viewFile()
+void Process::viewFile(const string& processName)
 {
-	string fileName = this->processName + ".txt";
+	string fileName = processName + ".txt";
 	fstream file;
 	file.open(fileName, std::ios::in);
 	std::string line;
@@ -2,17 +2,21 @@
 
 #include <vector>
 #include <fstream>
+#include <ctime>
 
 #include "ProcessScreen.h"
 #include "PrintCommand.h"
+#include "Bytecode.h"
+#include "TimerWheel.h"
+#include "ProcessTask.h"
 
 using namespace std;	
 
 #include <iostream>
-class Process : public ProcessScreen
+class Process : public ProcessScreen, public VariableStore
 {
 public:
-	Process(string processName, int currentLine, string timestamp, size_t memoryRequired);
+	Process(string processName, int currentLine, time_t timestamp, size_t memoryRequired);
 	~Process();
 
 	enum ProcessState
@@ -20,17 +24,18 @@ public:
 		READY,
 		RUNNING,
 		WAITING,
-		FINISHED
+		FINISHED,
+		SWAPPED	// Ready, but its memory is in the backing store
 	};
 
 	
-	void setProcessName(string processName);
 	void setCurrentLine(int currentLine);
 	void setTotalLine(int totalLine);
-	void setTimestamp(string timestamp);
-	void setTimestampFinished(string timestampFinished);
+	void setTimestamp(time_t timestamp);
+	void setTimestampFinished(time_t timestampFinished);
 	void setMemoryRequired(size_t memoryRequired);
 	void setNumPages(size_t numPages);
+	void setIoFrequency(int ioFrequency);
 
 	void executeCurrentCommand();
 	void moveToNextLine();
@@ -38,8 +43,8 @@ public:
 	int getCommandCounter() const;
 	int getCPUCoreID() const;
 	void setCPUCoreID(int coreID);
-	void createFile();
-	void viewFile();
+	static void createFile(const string& processName);
+	static void viewFile(const string& processName);
 	void setRandomIns();
 	size_t getMemoryRequired() const;
 	void setMemoryUsage(size_t memoryUsage);
@@ -47,8 +52,21 @@ public:
 	void setIsRunning(bool isRunning);
 	bool getIsRunning() const;
 
+	int getPid() const;
+	void setMemoryPtr(void* memoryPtr);
+	bool readVariable(int slot, uint16_t& value) override;
+	bool writeVariable(int slot, uint16_t value) override;
+	ExecutionState& getExecutionState();
+	void releaseProgram();
+	TimerWheel::Timer& getWakeupTimer();
+	ProcessTask& getTask();
+	void setTask(ProcessTask task);
+	std::vector<ExecutionState::LogEntry> getRecentLogs() const;
 	ProcessState getState() const;
+	void setState(ProcessState state);
+	bool setStateIf(ProcessState expected, ProcessState state);
 
+	string getConsoleName() override;
 	string getProcessName() override;
 	int getCurrentLine() override;
 	int getTotalLine() override;
@@ -57,18 +75,16 @@ public:
 	size_t getNumPages();
 
 private:
-	string processName;
-	int currentLine;
-	int totalLine;
+	// State, progress, core, memory, name and timestamps live in the ProcessTable under pid
+	int pid;
+	uint32_t seed;
 	int commandCounter;
-	int cpuCoreID = -1;
+	ExecutionState executionState;
+	TimerWheel::Timer wakeupTimer; // Pending end of a SLEEP
+	ProcessTask task; // Suspended execution, created on first dispatch and destroyed when finished
 	size_t numPages;
-	string timestamp;
-	bool isRunning = false;
-	string timestampFinished;
-	std::vector<PrintCommand> printCommands;
-	ProcessState currentState;
 	size_t memoryRequired;
-	size_t memoryUsage;
+	int ioFrequency;
+	char* memoryPtr = nullptr; // Start of the block in flat memory; paged processes go through their page table
 
 };
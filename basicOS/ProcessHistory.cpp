@@ -0,0 +1,66 @@
+#include <bit>
+
+#include "ProcessHistory.h"
+#include "Machine.h"
+#include "ProcessTable.h"
+
+using namespace std;
+
+ProcessHistory* ProcessHistory::processHistory = nullptr;
+
+ProcessHistory* ProcessHistory::getInstance() {
+	ProcessHistory*& instance = Machine::slot(&Machine::processHistory, processHistory);
+	if (instance == nullptr) {
+		instance = new ProcessHistory();
+	}
+	return instance;
+}
+
+// Copy the display fields of a finished process out of the ProcessTable
+void ProcessHistory::archive(int pid) {
+	ProcessTable* table = ProcessTable::getInstance();
+	std::lock_guard<std::mutex> lock(appendMutex);
+
+	size_t index = numRecords;
+	size_t chunk = chunkOf(index);
+	if (!chunks[chunk]) {
+		chunks[chunk] = std::make_unique<Record[]>(FIRST_CHUNK_SIZE << chunk);
+	}
+
+	Record& record = chunks[chunk][index - chunkStart(chunk)];
+	record.name = &table->name(pid);
+	record.created = table->created(pid);
+	record.finished = table->finished(pid);
+	record.pid = pid;
+	record.core = table->core(pid);
+	record.instructions = table->totalLine(pid);
+
+	// Publish the record only after it is fully written
+	numRecords = index + 1;
+}
+
+size_t ProcessHistory::getNumRecords() const {
+	return numRecords;
+}
+
+const ProcessHistory::Record& ProcessHistory::getRecord(size_t index) const {
+	size_t chunk = chunkOf(index);
+	return chunks[chunk][index - chunkStart(chunk)];
+}
+
+// Chunk k holds FIRST_CHUNK_SIZE << k records, starting at FIRST_CHUNK_SIZE * (2^k - 1)
+size_t ProcessHistory::chunkOf(size_t index) {
+	return std::bit_width(index / FIRST_CHUNK_SIZE + 1) - 1;
+}
+
+size_t ProcessHistory::chunkStart(size_t chunk) {
+	return FIRST_CHUNK_SIZE * ((size_t(1) << chunk) - 1);
+}
+
+// Oldest first
+void ProcessHistory::forEach(const std::function<void(const Record&)>& visit) const {
+	size_t count = numRecords;
+	for (size_t i = 0; i < count; i++) {
+		visit(getRecord(i));
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <ctime>
+#include <cstdint>
+#include <functional>
+
+// Append-only record of finished processes. A finished process is archived here and
+// released, so listings only walk live processes plus these small records.
+// Records live in chunks that never move, so readers need no lock. Each chunk is twice
+// the size of the one before, so the history keeps growing and never fills up.
+class ProcessHistory
+{
+public:
+	static const int FIRST_CHUNK_SIZE = 4096;
+	static const int MAX_CHUNKS = 48;
+
+	struct Record
+	{
+		const std::string* name; // Interned by the ProcessTable
+		std::time_t created;
+		std::time_t finished;
+		int pid;
+		int16_t core;
+		int32_t instructions;
+	};
+
+	static ProcessHistory* getInstance();
+
+	void archive(int pid);
+	size_t getNumRecords() const;
+	const Record& getRecord(size_t index) const;
+	void forEach(const std::function<void(const Record&)>& visit) const;
+
+private:
+	static size_t chunkOf(size_t index);
+	static size_t chunkStart(size_t chunk);
+
+	static ProcessHistory* processHistory;
+	std::unique_ptr<Record[]> chunks[MAX_CHUNKS];
+	std::atomic<size_t> numRecords = 0;
+	std::mutex appendMutex;
+};
@@ -0,0 +1,111 @@
+#include <mutex>
+
+#include "ProcessRegistry.h"
+#include "Machine.h"
+
+using namespace std;
+
+ProcessRegistry* ProcessRegistry::processRegistry = nullptr;
+
+ProcessRegistry* ProcessRegistry::getInstance() {
+	ProcessRegistry*& instance = Machine::slot(&Machine::processRegistry, processRegistry);
+	if (instance == nullptr) {
+		instance = new ProcessRegistry();
+	}
+	return instance;
+}
+
+ProcessRegistry::NameStripe& ProcessRegistry::stripeOf(const std::string& name) {
+	return nameStripes[std::hash<std::string>{}(name) % NUM_STRIPES];
+}
+
+ProcessRegistry::PidStripe& ProcessRegistry::stripeOf(int pid) {
+	return pidStripes[pid % NUM_STRIPES];
+}
+
+// Returns false if a screen with the same name is already registered
+bool ProcessRegistry::add(std::shared_ptr<ProcessScreen> screen) {
+	string name = screen->getConsoleName();
+	{
+		NameStripe& stripe = stripeOf(name);
+		std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+		if (!stripe.screens.emplace(name, screen).second) {
+			return false;
+		}
+	}
+
+	std::shared_ptr<Process> process = std::dynamic_pointer_cast<Process>(screen);
+	if (process) {
+		PidStripe& stripe = stripeOf(process->getPid());
+		std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+		stripe.processes[process->getPid()] = process;
+	}
+	return true;
+}
+
+// Removes this screen only; another screen registered under the same name is left alone
+bool ProcessRegistry::remove(const std::shared_ptr<ProcessScreen>& screen) {
+	string name = screen->getConsoleName();
+	{
+		NameStripe& stripe = stripeOf(name);
+		std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+		auto it = stripe.screens.find(name);
+		if (it == stripe.screens.end() || it->second != screen) {
+			return false;
+		}
+		stripe.screens.erase(it);
+	}
+
+	std::shared_ptr<Process> process = std::dynamic_pointer_cast<Process>(screen);
+	if (process) {
+		PidStripe& stripe = stripeOf(process->getPid());
+		std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+		auto it = stripe.processes.find(process->getPid());
+		if (it != stripe.processes.end() && it->second == process) {
+			stripe.processes.erase(it);
+		}
+	}
+	return true;
+}
+
+bool ProcessRegistry::contains(const std::string& name) {
+	NameStripe& stripe = stripeOf(name);
+	std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+	return stripe.screens.contains(name);
+}
+
+std::shared_ptr<ProcessScreen> ProcessRegistry::find(const std::string& name) {
+	NameStripe& stripe = stripeOf(name);
+	std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+	auto it = stripe.screens.find(name);
+	return it != stripe.screens.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<Process> ProcessRegistry::findProcess(const std::string& name) {
+	return std::dynamic_pointer_cast<Process>(find(name));
+}
+
+std::shared_ptr<Process> ProcessRegistry::findByPid(int pid) {
+	PidStripe& stripe = stripeOf(pid);
+	std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+	auto it = stripe.processes.find(pid);
+	return it != stripe.processes.end() ? it->second : nullptr;
+}
+
+size_t ProcessRegistry::getNumProcesses() {
+	size_t numProcesses = 0;
+	for (PidStripe& stripe : pidStripes) {
+		std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+		numProcesses += stripe.processes.size();
+	}
+	return numProcesses;
+}
+
+void ProcessRegistry::forEachProcess(const std::function<void(const std::shared_ptr<Process>&)>& visit) {
+	for (PidStripe& stripe : pidStripes) {
+		std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+		for (const auto& entry : stripe.processes) {
+			visit(entry.second);
+		}
+	}
+}
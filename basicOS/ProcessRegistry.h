@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <memory>
+#include <shared_mutex>
+#include <functional>
+
+#include "ProcessScreen.h"
+#include "Process.h"
+
+// Every screen by name and every process by PID. The maps are split into stripes,
+// each behind its own reader-writer lock, so lookups never copy the registry and
+// processes can be registered while other threads read it.
+class ProcessRegistry
+{
+public:
+	static const int NUM_STRIPES = 16;
+
+	static ProcessRegistry* getInstance();
+
+	bool add(std::shared_ptr<ProcessScreen> screen);
+	bool remove(const std::shared_ptr<ProcessScreen>& screen);
+	bool contains(const std::string& name);
+	std::shared_ptr<ProcessScreen> find(const std::string& name);
+	std::shared_ptr<Process> findProcess(const std::string& name);
+	std::shared_ptr<Process> findByPid(int pid);
+	size_t getNumProcesses();
+
+	// Visits every process in place, one stripe at a time under its read lock;
+	// the visitor must not add or remove processes
+	void forEachProcess(const std::function<void(const std::shared_ptr<Process>&)>& visit);
+
+private:
+	struct NameStripe
+	{
+		std::shared_mutex mutex;
+		std::unordered_map<std::string, std::shared_ptr<ProcessScreen>> screens;
+	};
+
+	struct PidStripe
+	{
+		std::shared_mutex mutex;
+		std::unordered_map<int, std::shared_ptr<Process>> processes;
+	};
+
+	NameStripe& stripeOf(const std::string& name);
+	PidStripe& stripeOf(int pid);
+
+	static ProcessRegistry* processRegistry;
+	NameStripe nameStripes[NUM_STRIPES];
+	PidStripe pidStripes[NUM_STRIPES];
+};
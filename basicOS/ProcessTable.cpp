@@ -0,0 +1,216 @@
+#include <stdexcept>
+
+#include "ProcessTable.h"
+#include "Machine.h"
+#include "TimerWheel.h"
+
+using namespace std;
+
+ProcessTable* ProcessTable::processTable = nullptr;
+
+ProcessTable* ProcessTable::getInstance() {
+	ProcessTable*& instance = Machine::slot(&Machine::processTable, processTable);
+	if (instance == nullptr) {
+		instance = new ProcessTable();
+	}
+	return instance;
+}
+
+// Register a new process and return its PID, reusing the most recently released one
+int ProcessTable::create(const std::string& name, std::time_t created, int totalLine) {
+	std::lock_guard<std::mutex> lock(createMutex);
+
+	int pid;
+	if (!freePids.empty()) {
+		pid = freePids.back();
+		freePids.pop_back();
+	}
+	else {
+		pid = numEntries;
+		if (pid / CHUNK_SIZE >= MAX_CHUNKS) {
+			throw std::runtime_error("Process table is full.");
+		}
+		if (!chunks[pid / CHUNK_SIZE]) {
+			chunks[pid / CHUNK_SIZE] = std::make_unique<Chunk>();
+		}
+		numEntries++;
+	}
+
+	Chunk& chunk = chunkOf(pid);
+	int index = pid % CHUNK_SIZE;
+	chunk.serial[index] = numCreated++;
+	chunk.isRunning[index] = false;
+	chunk.core[index] = -1;
+	chunk.currentLine[index] = 0;
+	chunk.totalLine[index] = totalLine;
+	chunk.memoryUsage[index] = 0;
+	chunk.name[index] = &internedNames.try_emplace(name, pid).first->first;
+	chunk.created[index] = created;
+	chunk.finished[index] = 0;
+	chunk.arrivalTick[index] = TimerWheel::getInstance()->getCurrentTick();
+	chunk.readyTick[index] = chunk.arrivalTick[index];
+	chunk.firstRunTick[index] = NO_TICK;
+	chunk.waitTicks[index] = 0;
+
+	numProcesses++;
+
+	// New processes start out ready
+	std::lock_guard<std::mutex> stateLock(stateMutex);
+	linkState(pid, 0);
+	return pid;
+}
+
+// Take a destroyed process off its state list and free its PID for reuse.
+// Its name stays interned, so archived records that point to it remain valid.
+void ProcessTable::release(int pid) {
+	{
+		std::lock_guard<std::mutex> stateLock(stateMutex);
+		unlinkState(pid);
+	}
+
+	std::lock_guard<std::mutex> lock(createMutex);
+	freePids.push_back(pid);
+	numProcesses--;
+}
+
+void ProcessTable::setState(int pid, uint8_t state) {
+	std::lock_guard<std::mutex> lock(stateMutex);
+	if (chunkOf(pid).state[pid % CHUNK_SIZE] != state) {
+		unlinkState(pid);
+		linkState(pid, state);
+	}
+}
+
+// Change the state only if the process is still in the expected one
+bool ProcessTable::setStateIf(int pid, uint8_t expected, uint8_t state) {
+	std::lock_guard<std::mutex> lock(stateMutex);
+	if (chunkOf(pid).state[pid % CHUNK_SIZE] != expected) {
+		return false;
+	}
+	if (expected != state) {
+		unlinkState(pid);
+		linkState(pid, state);
+	}
+	return true;
+}
+
+int ProcessTable::getNumInState(uint8_t state) {
+	std::lock_guard<std::mutex> lock(stateMutex);
+	return stateCount[state];
+}
+
+std::vector<int> ProcessTable::getPidsInState(uint8_t state) {
+	std::lock_guard<std::mutex> lock(stateMutex);
+	std::vector<int> pids;
+	pids.reserve(stateCount[state]);
+	for (int pid = stateHead[state]; pid != -1; pid = chunkOf(pid).nextInState[pid % CHUNK_SIZE]) {
+		pids.push_back(pid);
+	}
+	return pids;
+}
+
+// Append to the tail of the state's list; stateMutex must be held
+void ProcessTable::linkState(int pid, uint8_t state) {
+	Chunk& chunk = chunkOf(pid);
+	int index = pid % CHUNK_SIZE;
+
+	chunk.state[index] = state;
+	chunk.prevInState[index] = stateTail[state];
+	chunk.nextInState[index] = -1;
+
+	if (stateTail[state] != -1) {
+		chunkOf(stateTail[state]).nextInState[stateTail[state] % CHUNK_SIZE] = pid;
+	}
+	else {
+		stateHead[state] = pid;
+	}
+	stateTail[state] = pid;
+	stateCount[state]++;
+}
+
+void ProcessTable::unlinkState(int pid) {
+	Chunk& chunk = chunkOf(pid);
+	int index = pid % CHUNK_SIZE;
+	uint8_t state = chunk.state[index];
+	int prev = chunk.prevInState[index];
+	int next = chunk.nextInState[index];
+
+	if (prev != -1) {
+		chunkOf(prev).nextInState[prev % CHUNK_SIZE] = next;
+	}
+	else {
+		stateHead[state] = next;
+	}
+
+	if (next != -1) {
+		chunkOf(next).prevInState[next % CHUNK_SIZE] = prev;
+	}
+	else {
+		stateTail[state] = prev;
+	}
+	stateCount[state]--;
+}
+
+int ProcessTable::getNumProcesses() const {
+	return numProcesses;
+}
+
+ProcessTable::Chunk& ProcessTable::chunkOf(int pid) {
+	return *chunks[pid / CHUNK_SIZE];
+}
+
+uint8_t ProcessTable::state(int pid) {
+	return chunkOf(pid).state[pid % CHUNK_SIZE];
+}
+
+bool& ProcessTable::isRunning(int pid) {
+	return chunkOf(pid).isRunning[pid % CHUNK_SIZE];
+}
+
+int16_t& ProcessTable::core(int pid) {
+	return chunkOf(pid).core[pid % CHUNK_SIZE];
+}
+
+int32_t& ProcessTable::currentLine(int pid) {
+	return chunkOf(pid).currentLine[pid % CHUNK_SIZE];
+}
+
+int32_t& ProcessTable::totalLine(int pid) {
+	return chunkOf(pid).totalLine[pid % CHUNK_SIZE];
+}
+
+uint32_t& ProcessTable::memoryUsage(int pid) {
+	return chunkOf(pid).memoryUsage[pid % CHUNK_SIZE];
+}
+
+int32_t ProcessTable::serial(int pid) {
+	return chunkOf(pid).serial[pid % CHUNK_SIZE];
+}
+
+const std::string& ProcessTable::name(int pid) {
+	return *chunkOf(pid).name[pid % CHUNK_SIZE];
+}
+
+std::time_t& ProcessTable::created(int pid) {
+	return chunkOf(pid).created[pid % CHUNK_SIZE];
+}
+
+std::time_t& ProcessTable::finished(int pid) {
+	return chunkOf(pid).finished[pid % CHUNK_SIZE];
+}
+
+uint64_t& ProcessTable::arrivalTick(int pid) {
+	return chunkOf(pid).arrivalTick[pid % CHUNK_SIZE];
+}
+
+uint64_t& ProcessTable::readyTick(int pid) {
+	return chunkOf(pid).readyTick[pid % CHUNK_SIZE];
+}
+
+uint64_t& ProcessTable::firstRunTick(int pid) {
+	return chunkOf(pid).firstRunTick[pid % CHUNK_SIZE];
+}
+
+uint64_t& ProcessTable::waitTicks(int pid) {
+	return chunkOf(pid).waitTicks[pid % CHUNK_SIZE];
+}
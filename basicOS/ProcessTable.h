@@ -0,0 +1,99 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <ctime>
+#include <cstdint>
+#include <vector>
+
+// Process control blocks stored as a structure of arrays indexed by PID.
+// Entries live in fixed-size chunks that never move, so a PID can be read
+// from any thread while new processes are being created. A released entry's
+// PID is handed to the next new process, so the table only grows with the
+// number of processes alive at once.
+class ProcessTable
+{
+public:
+	static const int CHUNK_SIZE = 4096;
+	static const int MAX_CHUNKS = 1024;
+	static constexpr int NO_PID = -1;	// Owner of free memory
+	static constexpr uint64_t NO_TICK = UINT64_MAX;
+
+	static ProcessTable* getInstance();
+
+	int create(const std::string& name, std::time_t created, int totalLine);
+	void release(int pid);
+	int getNumProcesses() const;
+
+	// Per-state lists linked through the table by PID, in the order processes entered the state.
+	// State changes go through setState so the lists stay in step.
+	static const int NUM_STATES = 5;
+	void setState(int pid, uint8_t state);
+	bool setStateIf(int pid, uint8_t expected, uint8_t state);
+	int getNumInState(uint8_t state);
+	std::vector<int> getPidsInState(uint8_t state);
+
+	// Hot fields, touched on every scheduling decision
+	uint8_t state(int pid);
+	bool& isRunning(int pid);
+	int16_t& core(int pid);
+	int32_t& currentLine(int pid);
+	int32_t& totalLine(int pid);
+	uint32_t& memoryUsage(int pid);
+
+	// Cold fields, only needed for display
+	int32_t serial(int pid);	// Creation order; unlike the PID, never reused
+	const std::string& name(int pid);
+	std::time_t& created(int pid);
+	std::time_t& finished(int pid);
+
+	// Scheduling latency bookkeeping, in sim ticks
+	uint64_t& arrivalTick(int pid);
+	uint64_t& readyTick(int pid);
+	uint64_t& firstRunTick(int pid);
+	uint64_t& waitTicks(int pid);
+
+private:
+	struct Chunk
+	{
+		uint8_t state[CHUNK_SIZE];
+		bool isRunning[CHUNK_SIZE];
+		int16_t core[CHUNK_SIZE];
+		int32_t currentLine[CHUNK_SIZE];
+		int32_t totalLine[CHUNK_SIZE];
+		uint32_t memoryUsage[CHUNK_SIZE];
+		int32_t prevInState[CHUNK_SIZE];
+		int32_t nextInState[CHUNK_SIZE];
+
+		int32_t serial[CHUNK_SIZE];
+		const std::string* name[CHUNK_SIZE];
+		std::time_t created[CHUNK_SIZE];
+		std::time_t finished[CHUNK_SIZE];
+
+		uint64_t arrivalTick[CHUNK_SIZE];
+		uint64_t readyTick[CHUNK_SIZE];
+		uint64_t firstRunTick[CHUNK_SIZE];
+		uint64_t waitTicks[CHUNK_SIZE];
+	};
+
+	Chunk& chunkOf(int pid);
+	void linkState(int pid, uint8_t state);
+	void unlinkState(int pid);
+
+	static ProcessTable* processTable;
+	std::unique_ptr<Chunk> chunks[MAX_CHUNKS];
+	std::atomic<int> numProcesses = 0;	// Entries in use
+	int numEntries = 0;	// Entries ever handed out, released ones included
+	int numCreated = 0;
+	std::vector<int> freePids;
+	std::unordered_map<std::string, int> internedNames; // Node-based, so name pointers stay valid
+	std::mutex createMutex;
+
+	int stateHead[NUM_STATES] = { -1, -1, -1, -1, -1 };
+	int stateTail[NUM_STATES] = { -1, -1, -1, -1, -1 };
+	int stateCount[NUM_STATES] = {};
+	std::mutex stateMutex;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <coroutine>
+#include <utility>
+
+#include "ObjectPool.h"
+
+// Execution of one process as a stackless coroutine. Each resume runs the process for one tick
+// on its current core; it then yields why it stopped, and returns once the process finishes.
+// The frame stays with the process while it waits off-core, so a suspended process costs no host thread.
+class ProcessTask
+{
+public:
+	enum YieldReason
+	{
+		RUNNING,	// Keeps the core for the next tick
+		PREEMPTED,	// Quantum expired
+		BLOCKED,	// Waiting for an I/O device
+		SLEEPING,
+		FINISHED
+	};
+
+	struct promise_type
+	{
+		YieldReason reason = RUNNING;
+
+		// Frames all have the same size, so they recycle through the object pool
+		static void* operator new(size_t size) { return ObjectPool::getInstance()->allocate(size); }
+		static void operator delete(void* frame, size_t size) { ObjectPool::getInstance()->deallocate(frame, size); }
+
+		ProcessTask get_return_object() {
+			return ProcessTask(std::coroutine_handle<promise_type>::from_promise(*this));
+		}
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		std::suspend_always yield_value(YieldReason yieldReason) noexcept {
+			reason = yieldReason;
+			return {};
+		}
+		void return_void() noexcept { reason = FINISHED; }
+		void unhandled_exception() { throw; }
+	};
+
+	ProcessTask() = default;
+	explicit ProcessTask(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+	ProcessTask(ProcessTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+	ProcessTask& operator=(ProcessTask&& other) noexcept {
+		if (this != &other) {
+			reset();
+			handle = std::exchange(other.handle, nullptr);
+		}
+		return *this;
+	}
+	ProcessTask(const ProcessTask&) = delete;
+	ProcessTask& operator=(const ProcessTask&) = delete;
+	~ProcessTask() { reset(); }
+
+	// Run until the next yield and report why the process stopped
+	YieldReason resume() {
+		handle.resume();
+		return handle.promise().reason;
+	}
+
+	bool isValid() const { return static_cast<bool>(handle); }
+
+	void reset() {
+		if (handle) {
+			handle.destroy();
+			handle = nullptr;
+		}
+	}
+
+private:
+	std::coroutine_handle<promise_type> handle;
+};
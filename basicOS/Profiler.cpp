@@ -0,0 +1,128 @@
+#include <iostream>
+#include <iomanip>
+#include <thread>
+
+#include "Profiler.h"
+#include "ConsoleColor.h"
+
+using namespace std;
+
+const char* ZONE_NAMES[Profiler::NUM_ZONES] = {
+	"dispatch",
+	"flat allocate",
+	"flat deallocate",
+	"paging allocate",
+	"paging deallocate",
+	"backing store",
+	"swap out",
+	"swap in",
+	"report",
+	"render"
+};
+
+Profiler* Profiler::profiler = nullptr;
+
+Profiler* Profiler::getInstance() {
+	if (profiler == nullptr) {
+		profiler = new Profiler();
+	}
+	return profiler;
+}
+
+bool Profiler::isCompiledIn() {
+#ifdef BASICOS_PROFILE
+	return true;
+#else
+	return false;
+#endif
+}
+
+// The calling thread's table, registered on its first zone
+Profiler::ThreadTable& Profiler::getThreadTable() {
+	thread_local ThreadTable* threadTable = nullptr;
+
+	if (threadTable == nullptr) {
+		std::lock_guard<std::mutex> lock(threadTablesMutex);
+		threadTables.push_back(std::make_unique<ThreadTable>());
+		threadTable = threadTables.back().get();
+		threadTable->threadName = "thread " + std::to_string(threadTables.size() - 1);
+	}
+	return *threadTable;
+}
+
+void Profiler::setThreadName(const std::string& threadName) {
+	ThreadTable& threadTable = getThreadTable();
+	std::lock_guard<std::mutex> lock(threadTablesMutex);
+	threadTable.threadName = threadName;
+}
+
+void Profiler::add(Zone zone, uint64_t cycles) {
+	ThreadTable& threadTable = getThreadTable();
+
+	// Single writer, so plain loads and stores are enough
+	threadTable.counts[zone].store(threadTable.counts[zone].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	threadTable.cycles[zone].store(threadTable.cycles[zone].load(std::memory_order_relaxed) + cycles, std::memory_order_relaxed);
+}
+
+// Timestamp units per microsecond, measured once against the steady clock
+double Profiler::getCyclesPerMicrosecond() {
+	if (cyclesPerMicrosecond == 0) {
+		auto start = chrono::steady_clock::now();
+		uint64_t startCycles = readTimestamp();
+		std::this_thread::sleep_for(chrono::milliseconds(20));
+		uint64_t cycles = readTimestamp() - startCycles;
+		double microseconds = chrono::duration<double, std::micro>(chrono::steady_clock::now() - start).count();
+		cyclesPerMicrosecond = cycles / microseconds;
+	}
+	return cyclesPerMicrosecond;
+}
+
+void Profiler::print() {
+	if (!isCompiledIn()) {
+		cout << ConsoleColor::YELLOW << "Profiling zones are compiled out; build with BASICOS_PROFILE defined." << ConsoleColor::RESET << endl;
+		return;
+	}
+
+	double cyclesPerUs = getCyclesPerMicrosecond();
+	uint64_t totalCounts[NUM_ZONES] = {};
+	uint64_t totalCycles[NUM_ZONES] = {};
+
+	auto printRow = [cyclesPerUs](const char* zoneName, uint64_t count, uint64_t cycles) {
+		cout << "  " << left << setw(20) << zoneName << right << setw(10) << count << setw(16) << cycles
+			<< setw(12) << cycles / count << setw(12) << fixed << setprecision(1) << cycles / cyclesPerUs / 1000.0 << defaultfloat << endl;
+	};
+
+	std::lock_guard<std::mutex> lock(threadTablesMutex);
+	for (const auto& threadTable : threadTables) {
+		cout << ConsoleColor::BLUE << threadTable->threadName << ConsoleColor::RESET << endl;
+		cout << "  " << left << setw(20) << "zone" << right << setw(10) << "calls" << setw(16) << "cycles" << setw(12) << "avg" << setw(12) << "ms" << endl;
+
+		for (int zone = 0; zone < NUM_ZONES; zone++) {
+			uint64_t count = threadTable->counts[zone].load(std::memory_order_relaxed);
+			uint64_t cycles = threadTable->cycles[zone].load(std::memory_order_relaxed);
+			if (count > 0) {
+				printRow(ZONE_NAMES[zone], count, cycles);
+				totalCounts[zone] += count;
+				totalCycles[zone] += cycles;
+			}
+		}
+	}
+
+	cout << ConsoleColor::BLUE << "all threads" << ConsoleColor::RESET << endl;
+	for (int zone = 0; zone < NUM_ZONES; zone++) {
+		if (totalCounts[zone] > 0) {
+			printRow(ZONE_NAMES[zone], totalCounts[zone], totalCycles[zone]);
+		}
+	}
+	cout << endl;
+}
+
+void Profiler::reset() {
+	std::lock_guard<std::mutex> lock(threadTablesMutex);
+	for (const auto& threadTable : threadTables) {
+		for (int zone = 0; zone < NUM_ZONES; zone++) {
+			threadTable->counts[zone] = 0;
+			threadTable->cycles[zone] = 0;
+		}
+	}
+}
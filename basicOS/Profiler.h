@@ -0,0 +1,93 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PROFILER_HAS_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILER_HAS_RDTSC 1
+#endif
+
+// Scoped timing zones around the emulator's hot paths. Every thread accumulates into its
+// own table, so a zone costs two timestamp reads and two adds and never takes a lock.
+// Zones are inclusive, so dispatch also counts the allocation it triggers.
+// They are compiled in only when BASICOS_PROFILE is defined (Debug builds).
+class Profiler
+{
+public:
+	enum Zone
+	{
+		DISPATCH,
+		FLAT_ALLOCATE,
+		FLAT_DEALLOCATE,
+		PAGING_ALLOCATE,
+		PAGING_DEALLOCATE,
+		BACKING_STORE,
+		SWAP_OUT,
+		SWAP_IN,
+		REPORT,
+		RENDER,
+		NUM_ZONES
+	};
+
+	// Only the owning thread writes; the profile command reads while it runs
+	struct ThreadTable
+	{
+		std::string threadName;
+		std::atomic<uint64_t> counts[NUM_ZONES] = {};
+		std::atomic<uint64_t> cycles[NUM_ZONES] = {};
+	};
+
+	class Scope
+	{
+	public:
+		explicit Scope(Zone zone) : zone(zone), start(readTimestamp()) {}
+		~Scope() { Profiler::getInstance()->add(zone, readTimestamp() - start); }
+
+	private:
+		Zone zone;
+		uint64_t start;
+	};
+
+	static Profiler* getInstance();
+
+	// TSC cycles where available, otherwise steady clock nanoseconds
+	static uint64_t readTimestamp() {
+#ifdef PROFILER_HAS_RDTSC
+		return __rdtsc();
+#else
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+
+	static bool isCompiledIn();
+	void setThreadName(const std::string& threadName);
+	void add(Zone zone, uint64_t cycles);
+	void print();
+	void reset();
+
+private:
+	ThreadTable& getThreadTable();
+	double getCyclesPerMicrosecond();
+
+	static Profiler* profiler;
+	std::vector<std::unique_ptr<ThreadTable>> threadTables;	// Kept after their thread exits
+	std::mutex threadTablesMutex;
+	double cyclesPerMicrosecond = 0;
+};
+
+#ifdef BASICOS_PROFILE
+#define PROFILE_ZONE(zone) Profiler::Scope profileZone(Profiler::zone)
+#define PROFILE_THREAD(name) Profiler::getInstance()->setThreadName(name)
+#else
+#define PROFILE_ZONE(zone)
+#define PROFILE_THREAD(name)
+#endif
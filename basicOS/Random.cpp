@@ -0,0 +1,65 @@
+#include <random>
+
+#include "Random.h"
+#include "Machine.h"
+
+Random* Random::random = nullptr;
+
+static uint64_t mix(uint64_t value) {
+	value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+	return value ^ (value >> 31);
+}
+
+Random::Random(uint64_t seed)
+{
+	if (seed == 0) {
+		std::random_device rd;
+		seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+	}
+	this->seed = seed;
+}
+
+Random* Random::getInstance() {
+	Random*& instance = Machine::slot(&Machine::random, random);
+	if (instance == nullptr) {
+		instance = new Random(0);
+	}
+	return instance;
+}
+
+void Random::initialize(uint64_t seed) {
+	Random*& instance = Machine::slot(&Machine::random, random);
+	delete instance;
+	instance = new Random(seed);
+}
+
+uint64_t Random::getSeed() const {
+	return seed;
+}
+
+// Streams start far apart so equal indices in different streams are unrelated
+uint64_t Random::get(Stream stream, uint64_t index) const {
+	const uint64_t gamma = 0x9e3779b97f4a7c15ULL;
+	return mix(mix(seed + gamma * (static_cast<uint64_t>(stream) + 1)) + gamma * (index + 1));
+}
+
+int Random::uniform(Stream stream, uint64_t index, int min, int max) const {
+	if (max <= min) {
+		return min;
+	}
+	uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1;
+	return static_cast<int>(min + static_cast<int64_t>(get(stream, index) % range));
+}
+
+uint64_t Random::next(Stream stream) {
+	return get(stream, counters[stream]++);
+}
+
+int Random::nextUniform(Stream stream, int min, int max) {
+	return uniform(stream, counters[stream]++, min, max);
+}
+
+double Random::nextDouble(Stream stream) {
+	return (next(stream) >> 11) * (1.0 / (uint64_t(1) << 53));
+}
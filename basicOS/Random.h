@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+
+// Deterministic random numbers for the simulation. Every value is a pure function of the
+// seed, a stream and an index (splitmix64), so draws do not depend on thread timing or on
+// the order other streams are used in. A seed of 0 draws one from std::random_device.
+class Random
+{
+public:
+	enum Stream
+	{
+		INSTRUCTIONS,	// Instruction count of a process, indexed by pid
+		PROGRAM,		// Seed of a process's generated program, indexed by pid
+		PAGES,			// Pages per process
+		ARRIVALS,		// Gaps between scheduler-test arrivals and think times
+		SIZES,			// Instruction counts of scheduler-test processes
+		NUM_STREAMS
+	};
+
+	static Random* getInstance();
+	static void initialize(uint64_t seed);
+
+	uint64_t getSeed() const;
+
+	// The index-th value of a stream
+	uint64_t get(Stream stream, uint64_t index) const;
+	int uniform(Stream stream, uint64_t index, int min, int max) const;
+
+	// The stream's next value, for draws that have no natural index
+	uint64_t next(Stream stream);
+	int nextUniform(Stream stream, int min, int max);
+	double nextDouble(Stream stream);	// In [0, 1)
+
+private:
+	Random(uint64_t seed);
+
+	static Random* random;
+	uint64_t seed;
+	std::atomic<uint64_t> counters[NUM_STREAMS] = {};
+};
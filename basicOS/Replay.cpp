@@ -0,0 +1,285 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include "Replay.h"
+#include "ConsoleManager.h"
+#include "ConsoleColor.h"
+#include "Scheduler.h"
+#include "Process.h"
+#include "ObjectPool.h"
+#include "ProcessTable.h"
+#include "ProcessRegistry.h"
+#include "PagingAllocator.h"
+#include "LatencyStats.h"
+#include "TimerWheel.h"
+#include "Random.h"
+
+using namespace std;
+
+// A header names the columns instead of starting with a tick
+static bool isHeader(const string& field) {
+	size_t start = field.find_first_not_of(" \t");
+	return start != string::npos && !isdigit(static_cast<unsigned char>(field[start]));
+}
+
+static uint64_t parseNumber(const string& field) {
+	size_t end = 0;
+	uint64_t value = 0;
+	try {
+		value = stoull(field, &end);
+	}
+	catch (const std::exception&) {
+		end = 0;
+	}
+	if (end == 0 || field.find_first_not_of(" \t", end) != string::npos || field.find('-') != string::npos) {
+		throw std::invalid_argument("not a number: '" + field + "'");
+	}
+	return value;
+}
+
+bool Replay::load(const std::string& traceFile, std::vector<Arrival>& arrivals) {
+	std::ifstream file(traceFile);
+	if (!file) {
+		cerr << ConsoleColor::RED << "Cannot open trace " << traceFile << ConsoleColor::RESET << endl;
+		return false;
+	}
+
+	// A flat process keeps its variables in its block; a paged one must fit its virtual address space
+	ConsoleManager* console = ConsoleManager::getInstance();
+	size_t minMemory = ExecutionState::SYMBOL_TABLE_SIZE;
+	size_t maxMemory = console->getMaxOverallMem();
+	if (console->getMinMemPerProc() != console->getMaxMemPerProc()) {
+		minMemory = 1;
+		size_t frameSize = console->getMemPerFrame();
+		size_t virtualMemory = std::max(console->getVirtualMemPerProc(), console->getMaxMemPerProc());
+		maxMemory = std::min(maxMemory / frameSize, (virtualMemory + frameSize - 1) / frameSize) * frameSize;
+	}
+
+	string line;
+	int lineNumber = 0;
+	while (getline(file, line)) {
+		lineNumber++;
+		line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+
+		vector<string> fields;
+		stringstream lineStream(line);
+		string field;
+		while (getline(lineStream, field, ',')) {
+			fields.push_back(field);
+		}
+
+		if (arrivals.empty() && !fields.empty() && isHeader(fields[0])) {
+			continue;
+		}
+
+		try {
+			if (fields.size() < 3 || fields.size() > 5) {
+				throw std::invalid_argument("expected arrival_tick,instructions,memory[,priority[,io_percent]]");
+			}
+
+			Arrival arrival;
+			arrival.tick = parseNumber(fields[0]);
+			arrival.instructions = static_cast<int>(parseNumber(fields[1]));
+			arrival.memory = parseNumber(fields[2]);
+			arrival.priority = fields.size() > 3 ? static_cast<int>(parseNumber(fields[3])) : 0;
+			arrival.ioPercent = fields.size() > 4 ? static_cast<int>(parseNumber(fields[4])) : console->getIoFrequency();
+
+			if (arrival.instructions <= 0) {
+				throw std::invalid_argument("instructions must be positive");
+			}
+			if (arrival.memory < minMemory || arrival.memory > maxMemory) {
+				throw std::invalid_argument("memory must be between " + to_string(minMemory) + " and " + to_string(maxMemory) + " bytes");
+			}
+			if (arrival.ioPercent < 0 || arrival.ioPercent > 100) {
+				throw std::invalid_argument("io_percent must be between 0 and 100");
+			}
+			arrivals.push_back(arrival);
+		}
+		catch (const std::exception& e) {
+			cerr << ConsoleColor::RED << traceFile << ":" << lineNumber << ": " << e.what() << ConsoleColor::RESET << endl;
+			return false;
+		}
+	}
+
+	std::stable_sort(arrivals.begin(), arrivals.end(), [](const Arrival& a, const Arrival& b) { return a.tick < b.tick; });
+	return true;
+}
+
+static void printLatencyRow(std::ostream& out, const string& label, vector<Replay::Completion>& completions) {
+	uint64_t waiting = 0, response = 0, turnaround = 0;
+	for (const Replay::Completion& completion : completions) {
+		waiting += completion.waiting;
+		response += completion.response;
+		turnaround += completion.turnaround;
+	}
+
+	std::sort(completions.begin(), completions.end(), [](const Replay::Completion& a, const Replay::Completion& b) { return a.turnaround < b.turnaround; });
+	size_t p95 = (completions.size() * 95 + 99) / 100 - 1;
+	double count = static_cast<double>(completions.size());
+
+	out << std::left << setw(12) << label << std::right << setw(10) << completions.size() << fixed << setprecision(1)
+		<< setw(10) << waiting / count << setw(10) << response / count << setw(12) << turnaround / count
+		<< setw(10) << completions[p95].turnaround << defaultfloat << endl;
+}
+
+Replay::Result Replay::simulate(const std::vector<Arrival>& arrivals) {
+	ConsoleManager* console = ConsoleManager::getInstance();
+	console->initializeAllocators();
+	bool paging = console->getMinMemPerProc() != console->getMaxMemPerProc();
+
+	Scheduler::initialize(console->getNumCpu());
+	Scheduler* scheduler = Scheduler::getInstance();
+	scheduler->startSimulation();
+
+	TimerWheel* clock = TimerWheel::getInstance();
+	ProcessTable* table = ProcessTable::getInstance();
+	uint64_t startTick = clock->getCurrentTick();
+	int ticksPerExec = std::max(1, console->getDelayPerExec());
+
+	vector<shared_ptr<Process>> processes(arrivals.size());
+	Result result;
+	vector<size_t> live;	// Arrived and not finished
+	size_t next = 0;
+
+	while (next < arrivals.size() || !live.empty()) {
+		uint64_t now = clock->getCurrentTick() - startTick;
+
+		// Nothing to run before the next arrival: jump the clock ahead
+		if (live.empty() && arrivals[next].tick > now) {
+			clock->advance(arrivals[next].tick - now);
+			continue;
+		}
+
+		for (; next < arrivals.size() && arrivals[next].tick <= now; next++) {
+			const Arrival& arrival = arrivals[next];
+
+			// Only a registered process may be queued; a name already taken gets a suffix
+			string name = "P" + to_string(next + 1);
+			while (ProcessRegistry::getInstance()->contains(name)) {
+				name += "'";
+			}
+			shared_ptr<Process> process = makePooled<Process>(name, 0, time(nullptr), arrival.memory);
+			process->setTotalLine(arrival.instructions);
+			process->setIoFrequency(arrival.ioPercent);
+			if (paging) {
+				process->setNumPages((arrival.memory + console->getMemPerFrame() - 1) / console->getMemPerFrame());
+			}
+
+			processes[next] = process;
+			live.push_back(next);
+			if (!console->registerConsole(process)) {
+				throw std::logic_error("Process " + name + " could not be registered.");
+			}
+			scheduler->addProcessToQueue(process);
+		}
+
+		scheduler->step();
+
+		for (size_t i = 0; i < live.size();) {
+			const shared_ptr<Process>& process = processes[live[i]];
+			if (!process->isFinished()) {
+				i++;
+				continue;
+			}
+
+			int pid = process->getPid();
+			uint64_t arrivalTick = table->arrivalTick(pid);
+			result.completionsByPriority[arrivals[live[i]].priority].push_back({ table->waitTicks(pid), table->firstRunTick(pid) - arrivalTick, now + startTick - arrivalTick });
+
+			live[i] = live.back();
+			live.pop_back();
+		}
+	}
+
+	result.ticks = clock->getCurrentTick() - startTick;
+	double coreTicks = static_cast<double>(scheduler->getNumCores()) * std::max<uint64_t>(result.ticks / ticksPerExec, 1);
+	result.utilization = scheduler->getBusyCpuTicks() / coreTicks * 100;
+	result.throughput = arrivals.size() * 1000.0 / std::max<uint64_t>(result.ticks, 1);
+	result.instructions = scheduler->getCpuCycles();
+	result.dispatches = scheduler->getNumDispatches();
+	result.ioCompleted = scheduler->getNumIoCompleted();
+	result.faulted = scheduler->getNumFaulted();
+	result.pagedIn = paging ? PagingAllocator::getInstance()->getNumPagedIn() : 0;
+	result.pagedOut = paging ? PagingAllocator::getInstance()->getNumPagedOut() : 0;
+	result.cores = scheduler->getCoreUsage();
+	scheduler->stop();
+	return result;
+}
+
+int Replay::run(const std::string& traceFile, const std::string& reportFile) {
+	vector<Arrival> arrivals;
+	if (!load(traceFile, arrivals)) {
+		return 1;
+	}
+
+	auto wallStart = chrono::steady_clock::now();
+	Result result = simulate(arrivals);
+	double wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - wallStart).count();
+
+	ConsoleManager* console = ConsoleManager::getInstance();
+	Scheduler* scheduler = Scheduler::getInstance();
+	bool paging = console->getMinMemPerProc() != console->getMaxMemPerProc();
+	std::ostringstream report;
+
+	report << "Replay of " << traceFile << ": " << arrivals.size() << " processes" << endl;
+	report << "Scheduler: " << console->getSchedulerConfig();
+	if (console->getSchedulerConfig() == "rr") {
+		report << " q=" << console->getTimeSlice();
+	}
+	report << ", " << scheduler->getNumCores() << " cores, " << (paging ? "paging" : "flat") << " memory of " << console->getMaxOverallMem() << " bytes" << endl;
+	report << "Seed: " << Random::getInstance()->getSeed() << endl;
+	report << "-----------------------------------" << endl;
+	report << "Simulated ticks: " << result.ticks << endl;
+	report << "CPU utilization: " << fixed << setprecision(1) << result.utilization << "%" << endl;
+	report << "Throughput: " << setprecision(2) << result.throughput << " processes per 1000 ticks" << defaultfloat << endl;
+	report << "Instructions executed: " << result.instructions << endl;
+	report << "Dispatches: " << result.dispatches << endl;
+	report << "I/O requests completed: " << result.ioCompleted << endl;
+	if (paging) {
+		report << "Pages paged in / out: " << result.pagedIn << " / " << result.pagedOut << endl;
+	}
+	if (result.faulted > 0) {
+		report << "Processes faulted: " << result.faulted << endl;
+	}
+	report << "-----------------------------------" << endl;
+	Scheduler::printCoreUsage(report, result.cores, result.ticks);
+	report << "-----------------------------------" << endl;
+
+	report << "Latency by priority in ticks (mean, p95 of turnaround):" << endl;
+	report << std::left << setw(12) << "priority" << std::right << setw(10) << "processes" << setw(10) << "waiting"
+		<< setw(10) << "response" << setw(12) << "turnaround" << setw(10) << "p95" << endl;
+	vector<Completion> all;
+	for (auto& entry : result.completionsByPriority) {
+		all.insert(all.end(), entry.second.begin(), entry.second.end());
+		printLatencyRow(report, to_string(entry.first), entry.second);
+	}
+	if (!all.empty()) {
+		printLatencyRow(report, "all", all);
+	}
+	report << "-----------------------------------" << endl;
+	LatencyStats::getInstance()->printReport(report);
+
+	// Wall time stays out of the report so runs with the same seed compare byte for byte
+	if (reportFile.empty()) {
+		cout << report.str();
+		cerr << "Wall time: " << fixed << setprecision(3) << wallSeconds << " s" << endl;
+		return 0;
+	}
+
+	std::ofstream file(reportFile, std::ios::out | std::ios::trunc);
+	if (!file) {
+		cerr << ConsoleColor::RED << "Error: Could not open " << reportFile << " for writing." << ConsoleColor::RESET << endl;
+		return 1;
+	}
+	file << report.str();
+	cout << ConsoleColor::GREEN << "Replayed " << arrivals.size() << " processes in " << result.ticks << " ticks (" << fixed << setprecision(3) << wallSeconds << " s); report written to " << reportFile << ConsoleColor::RESET << endl;
+	return 0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+
+#include "Scheduler.h"
+
+// Headless mode: run a workload trace to completion on the sim clock, without the console,
+// the clock thread or the executors, and write a summary report.
+// A trace is CSV with one process per line:
+//   arrival_tick,instructions,memory,priority,io_percent
+// priority (default 0) and io_percent (default io-frequency) may be left out.
+// Blank lines, # comments and a header line are skipped.
+class Replay
+{
+public:
+	struct Arrival
+	{
+		uint64_t tick;
+		int instructions;
+		size_t memory;
+		int priority;
+		int ioPercent;
+	};
+
+	// Latencies of one finished process, in ticks
+	struct Completion
+	{
+		uint64_t waiting;
+		uint64_t response;
+		uint64_t turnaround;
+	};
+
+	struct Result
+	{
+		uint64_t ticks;
+		double utilization;	// Percent of core ticks with a process on the core
+		double throughput;	// Processes per 1000 ticks
+		int instructions;
+		size_t dispatches;
+		size_t ioCompleted;
+		size_t faulted;
+		size_t pagedIn;
+		size_t pagedOut;
+		std::map<int, std::vector<Completion>> completionsByPriority;
+		std::vector<Scheduler::CoreUsage> cores;
+	};
+
+	static int run(const std::string& traceFile, const std::string& reportFile);
+	static bool load(const std::string& traceFile, std::vector<Arrival>& arrivals);
+
+	// Run the arrivals to completion on this thread's configured machine
+	static Result simulate(const std::vector<Arrival>& arrivals);
+};
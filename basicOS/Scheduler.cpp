@@ -4,25 +4,65 @@
 #include <condition_variable>
 #include <mutex>
 #include <vector>
+#include <algorithm>
+#include <iomanip>
 
 #include "Scheduler.h"
 #include "ConsoleManager.h"
 #include "Process.h"
 #include "FlatMemoryAllocator.h"
 #include "PagingAllocator.h"
+#include "ProcessRegistry.h"
+#include "ProcessHistory.h"
+#include "ProcessTable.h"
+#include "Telemetry.h"
+#include "LatencyStats.h"
+#include "EventTrace.h"
+#include "Profiler.h"
+#include "SwapPool.h"
+#include "Machine.h"
 
 using namespace std;
 
 Scheduler::Scheduler(int numCores)
-    : numCores(numCores), schedulerRunning(false),
-    coresUsed(0), coresAvailable(numCores),
-    activeThreads(0),
-    processQueueMutex(), processQueueCondition() {}
+    : coresAvailable(numCores),
+    numCores(numCores),
+    cores(numCores),
+    interpreters(numCores),
+    processQueueMutex(), processQueueCondition(),
+    algorithm(ConsoleManager::getInstance()->getSchedulerConfig()) {
+    // The last listed speed covers the remaining cores
+    std::vector<double> speeds = ConsoleManager::getInstance()->getCoreSpeeds();
+    for (int core = 0; core < numCores && !speeds.empty(); core++) {
+        cores[core].speed = speeds[std::min<size_t>(core, speeds.size() - 1)];
+    }
+
+    // Rank the distinct speeds so placement can match work to cores
+    std::vector<double> levels;
+    for (const Core& core : cores) {
+        levels.push_back(core.speed);
+    }
+    std::sort(levels.begin(), levels.end());
+    levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+    for (Core& core : cores) {
+        size_t level = std::lower_bound(levels.begin(), levels.end(), core.speed) - levels.begin();
+        core.placement = levels.size() > 1 ? static_cast<double>(level) / (levels.size() - 1) : 0;
+    }
+    capacityAware = levels.size() > 1 && ConsoleManager::getInstance()->getCapacityAware();
+
+    // Cores take turns fastest first, so an idle fast core gets the pick of the ready queue
+    for (int core = 0; core < numCores; core++) {
+        coreOrder.push_back(core);
+    }
+    if (capacityAware) {
+        std::stable_sort(coreOrder.begin(), coreOrder.end(), [this](int a, int b) { return cores[a].speed > cores[b].speed; });
+    }
+}
 
 Scheduler* Scheduler::scheduler = nullptr;
 
 void Scheduler::initialize(int numCores) {
-    scheduler = new Scheduler(numCores);
+    Machine::slot(&Machine::scheduler, scheduler) = new Scheduler(numCores);
 }
 
 Scheduler::~Scheduler() {
@@ -34,135 +74,358 @@ Scheduler::Scheduler() {
     this->schedulerRunning = false;
     this->coresAvailable = 0;
 }
-void Scheduler::start() {
+
+// Policy, timers and I/O devices: everything but the sim clock and the executor threads
+void Scheduler::startSimulation() {
     schedulerRunning = true;
-    algorithm = ConsoleManager::getInstance()->getSchedulerConfig();
-    for (int i = 0; i < numCores; i++) {
+    startTick = TimerWheel::getInstance()->getCurrentTick();
+    LatencyStats::getInstance()->setPolicy(algorithm == "rr" ? "rr q=" + std::to_string(ConsoleManager::getInstance()->getTimeSlice()) : algorithm);
+
+    int snapshotInterval = ConsoleManager::getInstance()->getSnapshotInterval();
+    if (snapshotInterval > 0 && ConsoleManager::getInstance()->getMinMemPerProc() == ConsoleManager::getInstance()->getMaxMemPerProc()) {
+        TimerWheel::getInstance()->schedulePeriodic(snapshotTimer, snapshotInterval, [snapshotInterval]() {
+            FlatMemoryAllocator::getInstance()->printMemoryInfo(snapshotInterval);
+            });
+    }
+
+    // Sample utilization, memory and queue length into the telemetry ring buffer
+    Telemetry::getInstance()->start(ConsoleManager::getInstance()->getTelemetryInterval(), ConsoleManager::getInstance()->getTelemetryCapacity());
+
+    // I/O devices hand finished requests back to the front of the ready queue
+    for (int i = 0; i < std::max(1, ConsoleManager::getInstance()->getNumIoDevices()); i++) {
+        ioDevices.push_back(std::make_unique<IODevice>(i, ConsoleManager::getInstance()->getIoLatency()));
+        ioDevices.back()->start([this](std::shared_ptr<Process> process) {
+            process->setState(Process::READY);
+            LatencyStats::getInstance()->recordReady(process->getPid());
+            addToFrontOfProcessQueue(process);
+            });
+    }
+}
 
-        std::thread([this, i]() {
-            while (schedulerRunning) {
-                std::shared_ptr<Process> process;
+void Scheduler::start() {
+    startSimulation();
+
+    // Lockstep: the clock thread runs every core in order before each tick, so no two
+    // cores ever race and the same config and seed always interleave the same way
+    if (ConsoleManager::getInstance()->getLockstep()) {
+        int ticksPerExec = std::max(1, ConsoleManager::getInstance()->getDelayPerExec());
+        TimerWheel::getInstance()->start(ConsoleManager::getInstance()->getTickDuration(), [this, ticksPerExec]() {
+            if (schedulerRunning && TimerWheel::getInstance()->getCurrentTick() % ticksPerExec == 0) {
+                for (int core : coreOrder) {
+                    runTick(core);
+                }
+            }
+            });
+        return;
+    }
 
-                {
-                    std::unique_lock<std::mutex> lock(processQueueMutex);
-                    processQueueCondition.wait(lock, [this]() { return !processQueue.empty() || !schedulerRunning; });
+    // A few host threads drive all simulated cores; 0 uses one per host core
+    int numExecutors = ConsoleManager::getInstance()->getExecutorThreads();
+    if (numExecutors <= 0) {
+        numExecutors = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    numExecutors = std::min(numExecutors, numCores);
 
-                    if (!schedulerRunning) return;
+    // Quantum expiry, sleeps, I/O completion and snapshots are timers on the sim clock
+    TimerWheel::getInstance()->start(ConsoleManager::getInstance()->getTickDuration());
 
-                    process = processQueue.front();
-                    processQueue.pop();
-                    ++activeThreads;
-                }
+    tickBarrier = std::make_unique<std::barrier<>>(numExecutors);
+    Machine* machine = Machine::current();
+    for (int i = 0; i < numExecutors; i++) {
+        executors.emplace_back([this, i, numExecutors, machine]() {
+            if (machine != nullptr) {
+                machine->enter();
+            }
+            executorFunction(i, numExecutors);
+            });
+    }
+}
 
-                void* memoryPtr = nullptr;
-                bool isFlatMemory = ConsoleManager::getInstance()->getMinMemPerProc() == ConsoleManager::getInstance()->getMaxMemPerProc();
-                bool processInMemory = false;
+// Every tick, run each core owned by this executor: cores e, e + n, e + 2n, ... in turn order.
+// Executors count exec ticks from the same start and meet at the barrier after each one, so all
+// cores run the same tick; an executor that falls behind the clock catches up instead of skipping.
+void Scheduler::executorFunction(int executor, int numExecutors) {
+    PROFILE_THREAD("executor " + std::to_string(executor));
+    int ticksPerExec = std::max(1, ConsoleManager::getInstance()->getDelayPerExec());
 
+    for (uint64_t tick = startTick + ticksPerExec; schedulerRunning && TimerWheel::getInstance()->waitUntil(tick); tick += ticksPerExec) {
+        for (int turn = executor; turn < numCores; turn += numExecutors) {
+            runTick(coreOrder[turn]);
+        }
+        tickBarrier->arrive_and_wait();
+    }
+    tickBarrier->arrive_and_drop();
+}
 
-                if (isFlatMemory) {
-                    void* tempPtr = FlatMemoryAllocator::getInstance()->getMemoryPtr(process->getMemoryRequired(), process->getProcessName(), process);
+// Without executors or a clock thread: run every core in turn order, then advance the sim clock
+void Scheduler::step() {
+    for (int core : coreOrder) {
+        runTick(core);
+    }
+    TimerWheel::getInstance()->advance(std::max(1, ConsoleManager::getInstance()->getDelayPerExec()));
+}
 
-                    if (tempPtr) {
-                        memoryPtr = tempPtr;
-                    }
+// One tick of a core: dispatch onto it if it is idle, then run as many instructions as its
+// speed allows. A core slower than 1 runs an instruction only on the ticks its credit reaches 1.
+void Scheduler::runTick(int core) {
+    if (!cores[core].process && !dispatch(core)) {
+        idleCpuTicks++;
+        return;
+    }
+    cores[core].busyTicks++;
 
-                    // allocate the memory
-                    else {
-                        memoryPtr = FlatMemoryAllocator::getInstance()->allocate(process->getMemoryRequired(), process->getProcessName(), process);
-                    }
-                }
+    cores[core].credit += cores[core].speed;
+    int slots = static_cast<int>(cores[core].credit);
+    cores[core].credit -= slots;
 
+    for (int slot = 0; slot < slots; slot++) {
+        // A fast core that finishes a process picks up the next one within the same tick
+        if (!cores[core].process && !dispatch(core)) {
+            break;
+        }
 
+        // A preempted process gives the core to the next one within the same tick
+        if (!runCore(core) && dispatch(core)) {
+            runCore(core);
+        }
+    }
+}
 
-                // paging
-                else {
-                    // check if process is in memory
-                    processInMemory = PagingAllocator::getInstance()->isProcessInMemory(process->getProcessName());
+// Pop the process to run on the core. With cores of different speeds, the next few ready
+// processes (one per core) are ranked by length: the fastest cores take the longest and the
+// slowest the shortest, so long jobs do not crawl on slow cores. Ranking by total rather than
+// remaining instructions keeps a preempted job's place, and ties keep queue order.
+std::shared_ptr<Process> Scheduler::takeNextLocked(int core) {
+    size_t taken = 0;
+    if (capacityAware) {
+        size_t window = std::min<size_t>(processQueue.size(), numCores);
+        std::vector<std::pair<int, size_t>> candidates;
+        for (size_t i = 0; i < window; i++) {
+            candidates.emplace_back(processQueue[i]->getTotalLine(), i);
+        }
+        std::stable_sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        // The first of the longest (or shortest) jobs, so equal ones still take turns
+        size_t rank = static_cast<size_t>(cores[core].placement * (window - 1) + 0.5);
+        taken = window;
+        for (const auto& candidate : candidates) {
+            if (candidate.first == candidates[rank].first) {
+                taken = std::min(taken, candidate.second);
+            }
+        }
+    }
 
-                    if (processInMemory) {
-						// Does nothing, process is already in memory
-                    }
-                    // allocate the memory
-                    else {
-                        processInMemory = PagingAllocator::getInstance()->allocate(process);
+    std::shared_ptr<Process> process = processQueue[taken];
+    processQueue.erase(processQueue.begin() + taken);
+    return process;
+}
 
+// Put the next ready process on an idle core; returns false if none could be placed
+bool Scheduler::dispatch(int core) {
+    PROFILE_ZONE(DISPATCH);
+    std::shared_ptr<Process> process;
+    Process::ProcessState readyState;
+    {
+        // Claimed before its memory is looked up, so no other core evicts it meanwhile
+        std::lock_guard<std::mutex> lock(processQueueMutex);
+        if (processQueue.empty()) {
+            return false;
+        }
+        process = takeNextLocked(core);
+        readyState = process->getState();
+        process->setState(Process::RUNNING);
+    }
 
-                    }
-                }
+    void* memoryPtr = nullptr;
+    if (!allocateMemory(core, process, memoryPtr)) {
+        EventTrace::getInstance()->record(core, EventTrace::ALLOC_FAIL, process->getPid());
+        process->setState(readyState);
 
+        // fcfs keeps its order; rr tries again after the others
+        if (algorithm == "fcfs") {
+            addToFrontOfProcessQueue(process);
+        }
+        else {
+            addProcessToQueue(process);
+        }
+        return false;
+    }
 
-                if (memoryPtr || processInMemory) {
-                    coresAvailable--;
-                    coresUsed++;
-                    process->setCPUCoreID(i);
-                    process->setIsRunning(true);
-                    workerFunction(i, process, memoryPtr);
-                }
-                else {
-                    if (algorithm == "fcfs") {
-                        addToFrontOfProcessQueue(process);
-                    }
-                    else {
-                        coresAvailable--;
-                        coresUsed++;
-                        if (isFlatMemory) {
-                            std::shared_ptr<Process> oldestProcess = FlatMemoryAllocator::getInstance()->findOldestProcess();
-                            void* oldestMemoryPtr = FlatMemoryAllocator::getInstance()->getMemoryPtr(oldestProcess->getMemoryRequired(), oldestProcess->getProcessName(), oldestProcess);
+    {
+        std::lock_guard<std::mutex> lock(processQueueMutex);
+        coresAvailable--;
+        coresUsed++;
+        numDispatches++;
+    }
 
-                            FlatMemoryAllocator::getInstance()->deallocate(oldestMemoryPtr, oldestProcess);
+    cores[core].process = process;
+    cores[core].memoryPtr = memoryPtr;
+    process->setCPUCoreID(core);
+    process->setIsRunning(true);
+    LatencyStats::getInstance()->recordDispatch(process->getPid());
+    EventTrace::getInstance()->record(core, EventTrace::DISPATCH, process->getPid());
 
-                            // oldest process back to backing store
-                            FlatMemoryAllocator::getInstance()->allocateFromBackingStore(oldestProcess);
+    if (!process->getTask().isValid()) {
+        process->setTask(runProcess(process));
+    }
 
-                            // if the new process is in backing store, remove it from the backing store
-                            FlatMemoryAllocator::getInstance()->findAndRemoveProcessFromBackingStore(process);
+    // The quantum timer is cancelled if the process leaves the core before it expires. One that
+    // was already firing names its own dispatch, so it cannot preempt the next process here.
+    uint64_t dispatchNumber = ++cores[core].numDispatched;
+    if (algorithm == "rr") {
+        int ticksPerExec = std::max(1, ConsoleManager::getInstance()->getDelayPerExec());
+        TimerWheel::getInstance()->schedule(cores[core].quantumTimer, ConsoleManager::getInstance()->getTimeSlice() * ticksPerExec, [this, core, dispatchNumber]() {
+            cores[core].quantumExpiredFor = dispatchNumber;
+            });
+    }
+    return true;
+}
 
-                            // allocate the new process
-                            void* memoryPtr = FlatMemoryAllocator::getInstance()->allocate(process->getMemoryRequired(), process->getProcessName(), process);
+// Resume the process on the core for one tick; returns false if it was preempted without running
+bool Scheduler::runCore(int core) {
+    std::shared_ptr<Process> process = cores[core].process;
+    ProcessTask::YieldReason reason = process->getTask().resume();
+
+    switch (reason) {
+    case ProcessTask::RUNNING:
+        return true;
+
+    case ProcessTask::PREEMPTED:
+        EventTrace::getInstance()->record(core, EventTrace::PREEMPT, process->getPid());
+        releaseCore(core);
+        process->setState(Process::READY);
+        LatencyStats::getInstance()->recordReady(process->getPid());
+        addProcessToQueue(process);
+        return false;
+
+    case ProcessTask::BLOCKED:
+        EventTrace::getInstance()->record(core, EventTrace::BLOCK, process->getPid());
+        releaseCore(core);
+        submitIo(process);
+        return true;
+
+    case ProcessTask::SLEEPING:
+        EventTrace::getInstance()->record(core, EventTrace::SLEEP, process->getPid());
+        releaseCore(core);
+        sleepProcess(process);
+        return true;
+
+    case ProcessTask::FINISHED:
+    default:
+        EventTrace::getInstance()->record(core, EventTrace::FINISH, process->getPid());
+        releaseCore(core);
+        cores[core].completions++;
 
-                            if (memoryPtr) {
-                                process->setCPUCoreID(i);
-                                process->setIsRunning(true);
-                                workerFunction(i, process, memoryPtr);
-                            }
-                        }
-                        else {
-                            string oldestProcessStr = PagingAllocator::getInstance()->findOldestProcess();
-                            std::shared_ptr<Process> oldestProcess = ConsoleManager::getInstance()->getScreenByProcessName(oldestProcessStr);
+        // deallocate memory
+        if (ConsoleManager::getInstance()->getMinMemPerProc() == ConsoleManager::getInstance()->getMaxMemPerProc()) {
+            FlatMemoryAllocator::getInstance()->deallocate(cores[core].memoryPtr, process);
+        }
+        else {
+            PagingAllocator::getInstance()->deallocate(process);
+        }
 
-                            PagingAllocator::getInstance()->deallocate(oldestProcess);
+        process->getTask().reset();
+        process->setState(Process::FINISHED);
+        process->setTimestampFinished(time(nullptr));
+        LatencyStats::getInstance()->recordCompletion(process->getPid());
 
-                            PagingAllocator::getInstance()->allocateFromBackingStore(oldestProcess);
+        // Archive and release the finished process; listings only walk live processes
+        process->releaseProgram();
+        ProcessHistory::getInstance()->archive(process->getPid());
+        ProcessRegistry::getInstance()->remove(process);
+        return true;
+    }
+}
 
-                            PagingAllocator::getInstance()->findAndRemoveProcessFromBackingStore(process);
+// Execution of a process: one instruction per resume, yielding whenever it has to leave its core.
+// The process may come back on a different core, so the core is looked up on every tick.
+ProcessTask Scheduler::runProcess(std::shared_ptr<Process> process) {
+    while (!process->isFinished()) {
+        int core = process->getCPUCoreID();
 
-                            bool processInMemory = PagingAllocator::getInstance()->allocate(process);
+        if (cores[core].quantumExpiredFor == cores[core].numDispatched) {
+            co_yield ProcessTask::PREEMPTED;
+            continue;
+        }
 
-                            if (processInMemory) {
-                                process->setCPUCoreID(i);
-                                workerFunction(i, process, memoryPtr);
-                            }
-                        }
+        bool blocked = executeTick(core, process);
+        cpuCycles++;
+        cores[core].instructions++;
 
-                    }
+        if (process->isFinished()) {
+            break;
+        }
 
-                }
+        if (blocked) {
+            co_yield process->getExecutionState().sleepTicks > 0 ? ProcessTask::SLEEPING : ProcessTask::BLOCKED;
+        }
+        else {
+            co_yield ProcessTask::RUNNING;
+        }
+    }
+}
 
-                // Update core tracking after process completion
-                {
-                    std::lock_guard<std::mutex> lock(processQueueMutex);
-                    --activeThreads;
-
-                    if (processQueue.empty() && activeThreads == 0) {
-                        schedulerRunning = false;
-                        processQueueCondition.notify_all();
-                        coresUsed = 0;
-                        coresAvailable = ConsoleManager::getInstance()->getNumCpu();
-                    }
-                }
+// Find memory for the process, evicting the oldest process under rr when memory is full
+bool Scheduler::allocateMemory(int core, std::shared_ptr<Process> process, void*& memoryPtr) {
+    // Only looked up while tracing, so untraced dispatches skip the swap pool lock
+    bool swappedOut = EventTrace::getInstance()->isEnabled() && SwapPool::getInstance()->contains(process->getPid());
+
+    if (ConsoleManager::getInstance()->getMinMemPerProc() == ConsoleManager::getInstance()->getMaxMemPerProc()) {
+        memoryPtr = FlatMemoryAllocator::getInstance()->getMemoryPtr(process->getMemoryRequired(), process->getPid());
+
+        // allocate the memory
+        if (!memoryPtr) {
+            memoryPtr = FlatMemoryAllocator::getInstance()->allocate(process->getMemoryRequired(), process->getPid(), process);
+        }
+
+        if (!memoryPtr && algorithm == "rr") {
+            // oldest process back to backing store
+            int victim = FlatMemoryAllocator::getInstance()->swapOutOldest(process->getPid());
+            if (victim == ProcessTable::NO_PID) {
+                return false;
             }
-            }).detach();
+            EventTrace::getInstance()->record(core, EventTrace::SWAP_OUT, victim);
+
+            // if the new process is in backing store, remove it from the backing store
+            FlatMemoryAllocator::getInstance()->findAndRemoveProcessFromBackingStore(process);
+
+            // allocate the new process
+            memoryPtr = FlatMemoryAllocator::getInstance()->allocate(process->getMemoryRequired(), process->getPid(), process);
+        }
+
+        if (memoryPtr && swappedOut) {
+            EventTrace::getInstance()->record(core, EventTrace::SWAP_IN, process->getPid());
+        }
+        return memoryPtr != nullptr;
     }
+
+    // paging
+    bool allocated = PagingAllocator::getInstance()->isProcessInMemory(process->getPid()) ||
+        PagingAllocator::getInstance()->allocate(process);
+
+    if (!allocated && algorithm == "rr") {
+        int victim = PagingAllocator::getInstance()->swapOutOldest(process->getPid());
+        if (victim != ProcessTable::NO_PID) {
+            EventTrace::getInstance()->record(core, EventTrace::SWAP_OUT, victim);
+            PagingAllocator::getInstance()->findAndRemoveProcessFromBackingStore(process);
+            allocated = PagingAllocator::getInstance()->allocate(process);
+        }
+    }
+
+    if (allocated && swappedOut) {
+        EventTrace::getInstance()->record(core, EventTrace::SWAP_IN, process->getPid());
+    }
+    return allocated;
+}
+
+void Scheduler::releaseCore(int core) {
+    TimerWheel::getInstance()->cancel(cores[core].quantumTimer);
+    cores[core].process->setIsRunning(false);
+    cores[core].process = nullptr;
+
+    std::lock_guard<std::mutex> lock(processQueueMutex);
+    coresAvailable++;
+    coresUsed--;
 }
 
 int Scheduler::getCoresUsed() const {
@@ -178,138 +441,175 @@ int Scheduler::getIdleCpuTicks()
     return idleCpuTicks;
 }
 
+uint64_t Scheduler::getBusyCpuTicks() {
+    uint64_t busyTicks = 0;
+    for (const Core& core : cores) {
+        busyTicks += core.busyTicks;
+    }
+    return busyTicks;
+}
+
 void Scheduler::stop() {
     {
         std::lock_guard<std::mutex> lock(processQueueMutex);
         schedulerRunning = false;
     }
     processQueueCondition.notify_all();
-}
 
-void Scheduler::workerFunction(int core, std::shared_ptr<Process> process, void* memoryPtr) {
-    string timestamp = ConsoleManager::getInstance()->getCurrentTimestamp();
-
-
-    // Ensure the process keeps its original core for FCFS and RR
-    if (process->getCPUCoreID() == -1) {
-        process->setCPUCoreID(core);
+    TimerWheel::getInstance()->cancel(snapshotTimer);
+    Telemetry::getInstance()->stop();
+    for (auto& device : ioDevices) {
+        device->stop();
     }
-    else {
-        core = process->getCPUCoreID();
-    }
-
-    if (algorithm == "fcfs") {
-        for (int i = 0; i < process->getTotalLine(); i++) {
-            if (ConsoleManager::getInstance()->getDelayPerExec() != 0) {
-                for (int i = 0; i < ConsoleManager::getInstance()->getDelayPerExec(); i++) {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                }
-            }
-            else {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            }
-            process->setCurrentLine(process->getCurrentLine() + 1);
-            cpuCycles++;
+    TimerWheel::getInstance()->stop();
 
-            if (coresAvailable > 0) {
-                idleCpuTicks += coresAvailable;
-            }
+    // The stopped clock releases every executor from its wait
+    for (std::thread& executor : executors) {
+        if (executor.joinable()) {
+            executor.join();
         }
+    }
+    executors.clear();
+}
 
-        // subtract cores utilization
-        {
-            std::lock_guard<std::mutex> lock(processQueueMutex);
-            coresAvailable++;
-            coresUsed--;
-        }
+// Park the process on the device named by its last IO instruction; the core is already free
+void Scheduler::submitIo(std::shared_ptr<Process> process) {
+    process->setState(Process::WAITING);
+    process->setIsRunning(false);
+    if (!ioDevices.empty() && ioDevices[process->getExecutionState().ioDevice % ioDevices.size()]->submit(process)) {
+        return;
+    }
 
-        // deallocate memory
-        if (ConsoleManager::getInstance()->getMinMemPerProc() == ConsoleManager::getInstance()->getMaxMemPerProc()) {
-            FlatMemoryAllocator::getInstance()->deallocate(memoryPtr, process);
-        }
-        else {
-            PagingAllocator::getInstance()->deallocate(process);
-        }
+    // No device will serve it: the request fails at once and the process carries on
+    process->setState(Process::READY);
+    LatencyStats::getInstance()->recordReady(process->getPid());
+    addToFrontOfProcessQueue(process);
+}
 
+// Sleep off-core; the wakeup timer puts the process back at the front of the ready queue
+void Scheduler::sleepProcess(std::shared_ptr<Process> process) {
+    ExecutionState& state = process->getExecutionState();
+    int sleepTicks = state.sleepTicks * std::max(1, ConsoleManager::getInstance()->getDelayPerExec());
+    state.sleepTicks = 0;
+
+    process->setState(Process::WAITING);
+    process->setIsRunning(false);
+    TimerWheel::getInstance()->schedule(process->getWakeupTimer(), sleepTicks, [this, process]() {
+        process->setState(Process::READY);
+        LatencyStats::getInstance()->recordReady(process->getPid());
+        addToFrontOfProcessQueue(process);
+        });
+}
 
+size_t Scheduler::getNumWaitingForIo() {
+    size_t numWaiting = 0;
+    for (auto& device : ioDevices) {
+        numWaiting += device->getQueueLength();
     }
+    return numWaiting;
+}
 
-    else if (algorithm == "rr") {
-        int quantum = ConsoleManager::getInstance()->getTimeSlice();
+size_t Scheduler::getNumIoCompleted() {
+    size_t numCompleted = 0;
+    for (auto& device : ioDevices) {
+        numCompleted += device->getNumCompleted();
+    }
+    return numCompleted;
+}
 
-        for (int i = 0; i < quantum && process->getCurrentLine() < process->getTotalLine(); i++) {
-            if (ConsoleManager::getInstance()->getDelayPerExec() != 0) {
-                for (int i = 0; i < ConsoleManager::getInstance()->getDelayPerExec(); i++) {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                }
-            }
-            else {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            }
-            process->setCurrentLine(process->getCurrentLine() + 1);
+size_t Scheduler::getQueueLength() {
+    std::lock_guard<std::mutex> lock(processQueueMutex);
+    return processQueue.size();
+}
 
-            cpuCycles++;
+size_t Scheduler::getNumDispatches() {
+    std::lock_guard<std::mutex> lock(processQueueMutex);
+    return numDispatches;
+}
 
-            if (coresAvailable > 0) {
-                idleCpuTicks += coresAvailable;
-            }
-        }
+int Scheduler::getNumCores() const {
+    return numCores;
+}
 
-        if (process->getCurrentLine() < process->getTotalLine()) {
-            std::lock_guard<std::mutex> lock(processQueueMutex);
-            processQueue.push(process);  // Re-queue the unfinished process
-            processQueueCondition.notify_one();
-        }
+size_t Scheduler::getNumFaulted() const {
+    return numFaulted;
+}
 
+std::vector<Scheduler::CoreUsage> Scheduler::getCoreUsage() {
+    std::vector<CoreUsage> usage;
+    for (const Core& core : cores) {
+        usage.push_back({ core.speed, core.instructions, core.busyTicks, core.completions });
+    }
+    return usage;
+}
 
-        process->setIsRunning(false);
-        {
-            std::lock_guard<std::mutex> lock(processQueueMutex);
-            coresAvailable++;
-            coresUsed--;
-        }
+uint64_t Scheduler::getElapsedTicks() {
+    return TimerWheel::getInstance()->getCurrentTick() - startTick;
+}
 
+// One line per core: its speed, how busy it was and how much work it got through over ticks
+void Scheduler::printCoreUsage(std::ostream& out, const std::vector<CoreUsage>& usage, uint64_t ticks) {
+    double execTicks = static_cast<double>(std::max<uint64_t>(ticks / std::max(1, ConsoleManager::getInstance()->getDelayPerExec()), 1));
+    double perThousand = 1000.0 / std::max<uint64_t>(ticks, 1);
+
+    std::ios_base::fmtflags flags = out.flags();
+    out << std::setw(6) << "core" << std::setw(8) << "speed" << std::setw(8) << "busy%" << std::setw(14) << "instructions"
+        << std::setw(10) << "ins/tick" << std::setw(10) << "finished" << std::setw(12) << "per 1000t" << std::endl;
+    for (size_t core = 0; core < usage.size(); core++) {
+        out << std::setw(6) << core << std::fixed << std::setprecision(2) << std::setw(8) << usage[core].speed
+            << std::setprecision(1) << std::setw(8) << usage[core].busyTicks / execTicks * 100
+            << std::setw(14) << usage[core].instructions
+            << std::setprecision(2) << std::setw(10) << usage[core].instructions / execTicks
+            << std::setw(10) << usage[core].completions
+            << std::setw(12) << usage[core].completions * perThousand << std::endl;
     }
+    out.flags(flags);
+}
 
 
-    string timestampFinished = ConsoleManager::getInstance()->getCurrentTimestamp();
-    process->setTimestampFinished(timestampFinished);
-}
+// One tick of a core: execute the next instruction of the process.
+// Returns true when the process issued an I/O request or went to sleep and must give up the core.
+bool Scheduler::executeTick(int core, std::shared_ptr<Process> process) {
+    ExecutionState& state = process->getExecutionState();
 
+    Interpreter::StepResult result = interpreters[core].step(state);
+    if (result == Interpreter::EXECUTED || result == Interpreter::BLOCKED) {
+        process->moveToNextLine();
+    }
+    else if (result == Interpreter::FINISHED) {
+        process->setCurrentLine(process->getTotalLine());
+    }
+    else if (result == Interpreter::FAULTED) {
+        // Its variables stayed out of reach; end the process rather than retry forever
+        process->setCurrentLine(process->getTotalLine());
+        numFaulted++;
+    }
+    // STALLED: the instruction is retried on the next tick
+    return (result == Interpreter::BLOCKED || state.sleepTicks > 0) && !process->isFinished();
+}
 
 void Scheduler::addProcessToQueue(std::shared_ptr<Process> process) {
     {
         std::lock_guard<std::mutex> lock(processQueueMutex);
-        processQueue.push(process);
+        processQueue.push_back(process);
     }
     processQueueCondition.notify_one();
 }
 
 void Scheduler::addToFrontOfProcessQueue(std::shared_ptr<Process> process) {
     std::lock_guard<std::mutex> lock(processQueueMutex);
-
-    // Create a temporary queue and add the new process at the front
-    std::queue<std::shared_ptr<Process>> tempQueue;
-    tempQueue.push(process);
-
-    // Add the remaining processes to the temporary queue
-    while (!processQueue.empty()) {
-        tempQueue.push(processQueue.front());
-        processQueue.pop();
-    }
-
-    // Replace the original queue with the temporary queue
-    processQueue = std::move(tempQueue);
+    processQueue.push_front(process);
 
     processQueueCondition.notify_all();
 }
 
 
 Scheduler* Scheduler::getInstance() {
-    if (scheduler == nullptr) {
-        scheduler = new Scheduler();
+    Scheduler*& instance = Machine::slot(&Machine::scheduler, scheduler);
+    if (instance == nullptr) {
+        instance = new Scheduler();
     }
-    return scheduler;
+    return instance;
 }
 
 int Scheduler::getCpuCycles() const {
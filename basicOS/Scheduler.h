@@ -1,13 +1,22 @@
 #ifndef SCHEDULER_H
 #define SCHEDULER_H
 
-#include <queue>
+#include <deque>
+#include <vector>
+#include <ostream>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <memory>
+#include <atomic>
+#include <barrier>
+#include <cstdint>
 
 #include "Process.h"
+#include "Interpreter.h"
+#include "IODevice.h"
+#include "TimerWheel.h"
+#include "ProcessTask.h"
 
 class Scheduler {
 public:
@@ -20,13 +29,33 @@ public:
         FINISHED
     };
 
+    // What one core has done since the scheduler started
+    struct CoreUsage
+    {
+        double speed = 1;
+        uint64_t instructions = 0;
+        uint64_t busyTicks = 0;     // Ticks with a process on the core
+        uint64_t completions = 0;
+    };
+
     Scheduler(int numCores);
     Scheduler();
     ~Scheduler();
     void start();
+    void startSimulation();
+    void step();
     void stop();
     void addProcessToQueue(std::shared_ptr<Process> process);
-    void workerFunction(int core, std::shared_ptr<Process> process, void* ptr);
+    void executorFunction(int executor, int numExecutors);
+    void runTick(int core);
+    bool dispatch(int core);
+    bool runCore(int core);
+    ProcessTask runProcess(std::shared_ptr<Process> process);
+    bool allocateMemory(int core, std::shared_ptr<Process> process, void*& memoryPtr);
+    void releaseCore(int core);
+    bool executeTick(int core, std::shared_ptr<Process> process);
+    void submitIo(std::shared_ptr<Process> process);
+    void sleepProcess(std::shared_ptr<Process> process);
     static Scheduler* getInstance();
     static void initialize(int numCores);
     bool getSchedulerTestRunning() const;
@@ -36,22 +65,62 @@ public:
     int getCoresUsed() const;
     int getCoresAvailable() const;
     int getIdleCpuTicks();
+    uint64_t getBusyCpuTicks();
     int coresUsed = 0;
     int coresAvailable;
     int getCpuCycles() const;
+    size_t getNumWaitingForIo();
+    size_t getNumIoCompleted();
+    size_t getQueueLength();
+    size_t getNumDispatches();
+    size_t getNumFaulted() const;
+    int getNumCores() const;
     void setCpuCycles(int cpuCycles);
+    std::vector<CoreUsage> getCoreUsage();
+    uint64_t getElapsedTicks();
+    static void printCoreUsage(std::ostream& out, const std::vector<CoreUsage>& usage, uint64_t ticks);
 
 private:
+    // A simulated core; only the executor thread that owns it touches it
+    struct Core
+    {
+        std::shared_ptr<Process> process;
+        void* memoryPtr = nullptr;
+        TimerWheel::Timer quantumTimer;
+        uint64_t numDispatched = 0;
+        std::atomic<uint64_t> quantumExpiredFor = 0;    // The dispatch whose quantum ran out
+
+        // Instructions per tick (core-speeds in config.txt); credit carries fractions between ticks
+        double speed = 1;
+        double credit = 0;
+        double placement = 0;   // 0 on the slowest cores, 1 on the fastest
+
+        std::atomic<uint64_t> instructions = 0;
+        std::atomic<uint64_t> busyTicks = 0;
+        std::atomic<uint64_t> completions = 0;
+    };
+
+    std::shared_ptr<Process> takeNextLocked(int core);
+
     int numCores;
-    int cpuCycles = 0;
-    int idleCpuTicks = 0;
-    bool schedulerRunning;
-    int activeThreads;
+    std::atomic<int> cpuCycles = 0;
+    std::atomic<int> idleCpuTicks = 0;
+    std::atomic<size_t> numFaulted = 0;
+    std::atomic<bool> schedulerRunning = false;
     bool schedulerTestRunning = false;
-    std::vector<std::thread> workerThreads;
-    std::queue<std::shared_ptr<Process>> processQueue;
+    std::vector<Core> cores;
+    std::vector<int> coreOrder;
+    std::vector<std::thread> executors;
+    std::unique_ptr<std::barrier<>> tickBarrier;    // Holds every executor on the same tick
+    bool capacityAware = false;
+    uint64_t startTick = 0;
+    std::vector<Interpreter> interpreters;
+    std::vector<std::unique_ptr<IODevice>> ioDevices;
+    TimerWheel::Timer snapshotTimer;
+    std::deque<std::shared_ptr<Process>> processQueue;
     std::mutex processQueueMutex;
     std::condition_variable processQueueCondition;
+    size_t numDispatches = 0; // Guarded by processQueueMutex
     static Scheduler* scheduler;
     string algorithm = "";
 };
@@ -0,0 +1,176 @@
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <algorithm>
+
+#include "SwapPool.h"
+#include "LZCodec.h"
+#include "ConsoleColor.h"
+#include "Profiler.h"
+#include "Machine.h"
+
+using namespace std;
+
+SwapPool* SwapPool::swapPool = nullptr;
+
+SwapPool::SwapPool(size_t poolCapacity, const std::string& directory) : poolCapacity(poolCapacity), directory(directory)
+{
+}
+
+void SwapPool::initialize(size_t poolCapacity, const std::string& directory) {
+	Machine::slot(&Machine::swapPool, swapPool) = new SwapPool(poolCapacity, directory);
+}
+
+SwapPool* SwapPool::getInstance() {
+	return Machine::slot(&Machine::swapPool, swapPool);
+}
+
+string SwapPool::getSwapFileName(int pid) const {
+	return directory + "/pid" + std::to_string(pid) + ".swap";
+}
+
+// Store an evicted process image; returns the tier it ended up in
+SwapPool::Tier SwapPool::swapOut(int pid, const char* data, size_t size, size_t pageSize) {
+	PROFILE_ZONE(SWAP_OUT);
+	std::lock_guard<std::mutex> lock(swapMutex);
+	discardLocked(pid);
+
+	SwapEntry entry;
+	entry.size = size;
+	entry.pageSize = pageSize == 0 ? size : pageSize;
+
+	// Compress page by page so each page costs only what its contents need
+	size_t compressedSize = 0;
+	for (size_t offset = 0; offset < size; offset += entry.pageSize) {
+		entry.pages.emplace_back();
+		LZCodec::compress(data + offset, std::min(entry.pageSize, size - offset), entry.pages.back());
+		compressedSize += entry.pages.back().size();
+	}
+
+	if (poolUsed + compressedSize <= poolCapacity) {
+		entry.tier = POOL;
+		poolUsed += compressedSize;
+		stats[POOL].bytesStored += compressedSize;
+	}
+	else {
+		// Pool is full: fall back to the on-disk store
+		entry.tier = DISK;
+		entry.pages.clear();
+
+		std::filesystem::create_directories(directory);
+		std::ofstream file(getSwapFileName(pid), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) {
+			return NONE;
+		}
+		file.write(data, size);
+		stats[DISK].bytesStored += size;
+	}
+
+	stats[entry.tier].pagesOut += (size + entry.pageSize - 1) / entry.pageSize;
+	stats[entry.tier].bytesOut += size;
+
+	Tier tier = entry.tier;
+	entries[pid] = std::move(entry);
+	return tier;
+}
+
+// Restore an evicted process image into data; returns the tier it came from
+SwapPool::Tier SwapPool::swapIn(int pid, char* data, size_t size) {
+	PROFILE_ZONE(SWAP_IN);
+	std::lock_guard<std::mutex> lock(swapMutex);
+
+	auto it = entries.find(pid);
+	if (it == entries.end() || it->second.size != size) {
+		return NONE;
+	}
+
+	SwapEntry& entry = it->second;
+	Tier tier = entry.tier;
+	auto start = chrono::steady_clock::now();
+
+	if (tier == POOL) {
+		size_t offset = 0;
+		for (const auto& page : entry.pages) {
+			size_t pageBytes = std::min(entry.pageSize, size - offset);
+			if (!LZCodec::decompress(page.data(), page.size(), data + offset, pageBytes)) {
+				return NONE;
+			}
+			offset += pageBytes;
+		}
+	}
+	else {
+		std::ifstream file(getSwapFileName(pid), std::ios::in | std::ios::binary);
+		if (!file.read(data, size)) {
+			return NONE;
+		}
+	}
+
+	auto end = chrono::steady_clock::now();
+	stats[tier].pagesIn += (size + entry.pageSize - 1) / entry.pageSize;
+	stats[tier].swapInNanoseconds += chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+
+	discardLocked(pid);
+	return tier;
+}
+
+bool SwapPool::contains(int pid) {
+	std::lock_guard<std::mutex> lock(swapMutex);
+	return entries.contains(pid);
+}
+
+void SwapPool::discard(int pid) {
+	std::lock_guard<std::mutex> lock(swapMutex);
+	discardLocked(pid);
+}
+
+void SwapPool::discardLocked(int pid) {
+	auto it = entries.find(pid);
+	if (it == entries.end()) {
+		return;
+	}
+
+	if (it->second.tier == POOL) {
+		for (const auto& page : it->second.pages) {
+			poolUsed -= page.size();
+		}
+	}
+	else {
+		std::error_code error;
+		std::filesystem::remove(getSwapFileName(pid), error);
+	}
+	entries.erase(it);
+}
+
+size_t SwapPool::getPoolCapacity() const {
+	return poolCapacity;
+}
+
+size_t SwapPool::getPoolUsed() {
+	std::lock_guard<std::mutex> lock(swapMutex);
+	return poolUsed;
+}
+
+SwapPool::TierStats SwapPool::getStats(Tier tier) {
+	std::lock_guard<std::mutex> lock(swapMutex);
+	return stats[tier];
+}
+
+// Print compression ratio and swap-in latency of each tier
+void SwapPool::printStats() {
+	const char* tierNames[] = { "compressed pool", "disk" };
+
+	for (Tier tier : { POOL, DISK }) {
+		TierStats tierStats = getStats(tier);
+		double ratio = tierStats.bytesStored == 0 ? 0 : static_cast<double>(tierStats.bytesOut) / tierStats.bytesStored;
+		double latencyUs = tierStats.pagesIn == 0 ? 0 : tierStats.swapInNanoseconds / 1000.0 / tierStats.pagesIn;
+
+		cout << ConsoleColor::BLUE << tierStats.pagesOut << ConsoleColor::RESET << " pages swapped out to " << tierNames[tier] << endl;
+		cout << ConsoleColor::BLUE << tierStats.pagesIn << ConsoleColor::RESET << " pages swapped in from " << tierNames[tier] << endl;
+		if (tier == POOL) {
+			cout << ConsoleColor::BLUE << ratio << ConsoleColor::RESET << " compression ratio" << endl;
+		}
+		cout << ConsoleColor::BLUE << latencyUs << ConsoleColor::RESET << " us swap-in latency per page (" << tierNames[tier] << ")" << endl;
+	}
+	cout << ConsoleColor::BLUE << getPoolUsed() << " / " << poolCapacity << ConsoleColor::RESET << " bytes in compressed pool" << endl;
+}
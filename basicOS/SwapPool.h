@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+
+// Backing store for evicted process images. Pages are first kept LZ-compressed in an
+// in-memory pool (like zram); once the pool is full they are written to disk uncompressed.
+class SwapPool
+{
+public:
+	enum Tier
+	{
+		POOL,
+		DISK,
+		NONE
+	};
+
+	struct TierStats
+	{
+		size_t pagesOut = 0;
+		size_t pagesIn = 0;
+		size_t bytesOut = 0;
+		size_t bytesStored = 0;
+		uint64_t swapInNanoseconds = 0;
+	};
+
+	SwapPool(size_t poolCapacity, const std::string& directory);
+
+	static void initialize(size_t poolCapacity, const std::string& directory = "backing-store");
+	static SwapPool* getInstance();
+
+	Tier swapOut(int pid, const char* data, size_t size, size_t pageSize);
+	Tier swapIn(int pid, char* data, size_t size);
+	bool contains(int pid);
+	void discard(int pid);
+
+	size_t getPoolCapacity() const;
+	size_t getPoolUsed();
+	TierStats getStats(Tier tier);
+	void printStats();
+
+private:
+	struct SwapEntry
+	{
+		Tier tier;
+		size_t size;
+		size_t pageSize;
+		std::vector<std::vector<uint8_t>> pages; // compressed pages when tier is POOL
+	};
+
+	std::string getSwapFileName(int pid) const;
+	void discardLocked(int pid);
+
+	static SwapPool* swapPool;
+	size_t poolCapacity;
+	std::string directory; // Disk tier
+	size_t poolUsed = 0;
+	std::unordered_map<int, SwapEntry> entries; // Keyed by PID
+	TierStats stats[2];
+	std::mutex swapMutex;
+};
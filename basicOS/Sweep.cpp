@@ -0,0 +1,287 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+
+#include "Sweep.h"
+#include "Replay.h"
+#include "Machine.h"
+#include "ConsoleManager.h"
+#include "ConsoleColor.h"
+
+using namespace std;
+
+// Measurements of one grid point; not ok when the trace does not fit its memory settings
+struct Row
+{
+	bool ok = false;
+	Replay::Result result;
+	double meanWaiting = 0;
+	double meanResponse = 0;
+	uint64_t p50 = 0;
+	uint64_t p95 = 0;
+	uint64_t p99 = 0;
+};
+
+static uint64_t percentile(const vector<uint64_t>& sorted, int percent) {
+	return sorted[(sorted.size() * percent + 99) / 100 - 1];
+}
+
+bool Sweep::loadGrid(const std::string& gridFile, std::vector<std::string>& keys, std::vector<Settings>& configs) {
+	std::ifstream file(gridFile);
+	if (!file) {
+		cerr << ConsoleColor::RED << "Cannot open grid " << gridFile << ConsoleColor::RESET << endl;
+		return false;
+	}
+
+	// Try every value on a scratch machine so a typo fails before anything runs
+	Machine scratch;
+	scratch.enter();
+	ConsoleManager::initialize(false);
+
+	vector<vector<string>> values;
+	string line;
+	int lineNumber = 0;
+	string error;
+	while (error.empty() && getline(file, line)) {
+		lineNumber++;
+		line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
+
+		stringstream lineStream(line);
+		string key;
+		if (!(lineStream >> key) || key[0] == '#') {
+			continue;
+		}
+
+		vector<string> keyValues;
+		string value;
+		while (lineStream >> value) {
+			keyValues.push_back(value);
+		}
+
+		if (keyValues.empty()) {
+			error = "no values for " + key;
+		}
+		else if (std::find(keys.begin(), keys.end(), key) != keys.end()) {
+			error = key + " is listed twice";
+		}
+		for (const string& keyValue : keyValues) {
+			if (!error.empty()) {
+				break;
+			}
+			try {
+				if (!ConsoleManager::getInstance()->setConfiguration(key, keyValue)) {
+					error = "unknown setting " + key;
+				}
+			}
+			catch (const std::exception&) {
+				error = "bad value for " + key + ": '" + keyValue + "'";
+			}
+		}
+
+		if (!error.empty()) {
+			cerr << ConsoleColor::RED << gridFile << ":" << lineNumber << ": " << error << ConsoleColor::RESET << endl;
+		}
+		keys.push_back(key);
+		values.push_back(keyValues);
+	}
+	Machine::leave();
+
+	if (!error.empty()) {
+		return false;
+	}
+	if (keys.empty()) {
+		cerr << ConsoleColor::RED << gridFile << " lists no settings" << ConsoleColor::RESET << endl;
+		return false;
+	}
+
+	// Every combination, the last setting varying fastest
+	configs.assign(1, Settings());
+	for (size_t k = 0; k < keys.size(); k++) {
+		vector<Settings> expanded;
+		for (const Settings& config : configs) {
+			for (const string& value : values[k]) {
+				expanded.push_back(config);
+				expanded.back().emplace_back(keys[k], value);
+			}
+		}
+		configs.swap(expanded);
+	}
+	return true;
+}
+
+// Build a machine from config.txt plus the grid point, replay the trace on it and tear it down
+static Row runConfig(const Sweep::Settings& settings, const string& traceFile, size_t index) {
+	Row row;
+	string swapDirectory = "backing-store/sweep-" + to_string(index);
+	{
+		Machine machine;
+		machine.enter();
+
+		// Machines must not share swap files; memory stamps are a console aid and would collide
+		Sweep::Settings overrides = settings;
+		overrides.emplace_back("swap-directory", swapDirectory);
+		overrides.emplace_back("snapshot-interval", "0");
+		ConsoleManager::initialize(false);
+		ConsoleManager::getInstance()->initializeConfiguration(overrides);
+
+		vector<Replay::Arrival> arrivals;
+		if (Replay::load(traceFile, arrivals)) {
+			row.result = Replay::simulate(arrivals);
+			row.ok = true;
+		}
+		Machine::leave();
+	}
+
+	vector<uint64_t> turnarounds;
+	for (const auto& entry : row.result.completionsByPriority) {
+		for (const Replay::Completion& completion : entry.second) {
+			row.meanWaiting += completion.waiting;
+			row.meanResponse += completion.response;
+			turnarounds.push_back(completion.turnaround);
+		}
+	}
+	if (!turnarounds.empty()) {
+		std::sort(turnarounds.begin(), turnarounds.end());
+		row.meanWaiting /= turnarounds.size();
+		row.meanResponse /= turnarounds.size();
+		row.p50 = percentile(turnarounds, 50);
+		row.p95 = percentile(turnarounds, 95);
+		row.p99 = percentile(turnarounds, 99);
+	}
+
+	std::error_code ignored;
+	std::filesystem::remove_all(swapDirectory, ignored);
+	return row;
+}
+
+static void writeTable(std::ostream& out, const vector<string>& keys, const vector<Sweep::Settings>& configs, const vector<Row>& rows, bool csv) {
+	const vector<string> metrics = csv
+		? vector<string>{ "ticks", "cpu_utilization", "throughput", "mean_waiting", "mean_response", "turnaround_p50", "turnaround_p95", "turnaround_p99", "paged_in", "paged_out" }
+		: vector<string>{ "ticks", "cpu%", "tput", "wait", "resp", "p50", "p95", "p99", "pg-in", "pg-out" };
+
+	vector<size_t> widths;
+	for (size_t k = 0; k < keys.size(); k++) {
+		size_t width = keys[k].size();
+		for (const Sweep::Settings& config : configs) {
+			width = std::max(width, config[k].second.size());
+		}
+		widths.push_back(width + 2);
+	}
+
+	for (size_t k = 0; k < keys.size(); k++) {
+		if (csv) {
+			out << keys[k] << ",";
+		}
+		else {
+			out << setw(widths[k]) << keys[k];
+		}
+	}
+	for (size_t m = 0; m < metrics.size(); m++) {
+		if (csv) {
+			out << metrics[m] << (m + 1 < metrics.size() ? "," : "");
+		}
+		else {
+			out << setw(m == 0 ? 9 : 8) << metrics[m];
+		}
+	}
+	out << endl;
+
+	for (size_t i = 0; i < rows.size(); i++) {
+		for (size_t k = 0; k < keys.size(); k++) {
+			if (csv) {
+				out << configs[i][k].second << ",";
+			}
+			else {
+				out << setw(widths[k]) << configs[i][k].second;
+			}
+		}
+
+		const Row& row = rows[i];
+		if (!row.ok) {
+			out << (csv ? ",,,,,,,,," : "   failed") << endl;
+			continue;
+		}
+
+		std::ostringstream cells[10];
+		cells[0] << row.result.ticks;
+		cells[1] << fixed << setprecision(1) << row.result.utilization;
+		cells[2] << fixed << setprecision(2) << row.result.throughput;
+		cells[3] << fixed << setprecision(1) << row.meanWaiting;
+		cells[4] << fixed << setprecision(1) << row.meanResponse;
+		cells[5] << row.p50;
+		cells[6] << row.p95;
+		cells[7] << row.p99;
+		cells[8] << row.result.pagedIn;
+		cells[9] << row.result.pagedOut;
+		for (size_t m = 0; m < metrics.size(); m++) {
+			if (csv) {
+				out << cells[m].str() << (m + 1 < metrics.size() ? "," : "");
+			}
+			else {
+				out << setw(m == 0 ? 9 : 8) << cells[m].str();
+			}
+		}
+		out << endl;
+	}
+}
+
+int Sweep::run(const std::string& gridFile, const std::string& traceFile, int numJobs, const std::string& reportFile) {
+	vector<string> keys;
+	vector<Settings> configs;
+	if (!loadGrid(gridFile, keys, configs)) {
+		return 1;
+	}
+
+	if (numJobs <= 0) {
+		numJobs = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	}
+	numJobs = static_cast<int>(std::min<size_t>(numJobs, configs.size()));
+
+	// Each host thread takes the next grid point until none are left
+	vector<Row> rows(configs.size());
+	std::atomic<size_t> next = 0;
+	auto wallStart = chrono::steady_clock::now();
+	vector<std::thread> workers;
+	for (int j = 0; j < numJobs; j++) {
+		workers.emplace_back([&]() {
+			for (size_t i = next++; i < configs.size(); i = next++) {
+				rows[i] = runConfig(configs[i], traceFile, i);
+			}
+			});
+	}
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	double wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - wallStart).count();
+
+	bool csv = reportFile.size() >= 4 && reportFile.compare(reportFile.size() - 4, 4, ".csv") == 0;
+	std::ostringstream report;
+	if (!csv) {
+		report << "Sweep of " << traceFile << ": " << configs.size() << " configurations" << endl;
+		report << "Latencies in ticks: mean waiting and response, turnaround percentiles; throughput per 1000 ticks" << endl;
+	}
+	writeTable(report, keys, configs, rows, csv);
+
+	if (reportFile.empty()) {
+		cout << report.str();
+	}
+	else {
+		std::ofstream file(reportFile, std::ios::out | std::ios::trunc);
+		if (!file) {
+			cerr << ConsoleColor::RED << "Error: Could not open " << reportFile << " for writing." << ConsoleColor::RESET << endl;
+			return 1;
+		}
+		file << report.str();
+	}
+	cout << ConsoleColor::GREEN << "Ran " << configs.size() << " configurations on " << numJobs << " threads in " << fixed << setprecision(3) << wallSeconds << " s"
+		<< (reportFile.empty() ? "" : "; report written to " + reportFile) << ConsoleColor::RESET << endl;
+
+	size_t failed = std::count_if(rows.begin(), rows.end(), [](const Row& row) { return !row.ok; });
+	return failed == 0 ? 0 : 1;
+}
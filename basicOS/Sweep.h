@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility>
+
+// Parameter sweep: replay one workload trace on a grid of configurations, each on its own
+// simulated Machine, several at a time on host threads, and tabulate the results.
+// A grid file lists one setting per line in config.txt syntax with any number of values:
+//   quantum-cycles 2 5 10
+//   num-cpu 2 4 8
+// Every combination runs once on top of config.txt. Blank lines and # comments are skipped.
+class Sweep
+{
+public:
+	typedef std::vector<std::pair<std::string, std::string>> Settings;
+
+	static int run(const std::string& gridFile, const std::string& traceFile, int numJobs, const std::string& reportFile);
+	static bool loadGrid(const std::string& gridFile, std::vector<std::string>& keys, std::vector<Settings>& configs);
+};
@@ -0,0 +1,153 @@
+#include <fstream>
+#include <algorithm>
+
+#include "Telemetry.h"
+#include "Machine.h"
+#include "ConsoleManager.h"
+#include "Scheduler.h"
+#include "FlatMemoryAllocator.h"
+#include "PagingAllocator.h"
+
+using namespace std;
+
+// Binary export: header followed by the raw samples, oldest first
+const char TELEMETRY_MAGIC[4] = { 'B', 'O', 'S', 'T' };
+const uint32_t TELEMETRY_VERSION = 1;
+
+Telemetry* Telemetry::telemetry = nullptr;
+
+Telemetry* Telemetry::getInstance() {
+	Telemetry*& instance = Machine::slot(&Machine::telemetry, telemetry);
+	if (instance == nullptr) {
+		instance = new Telemetry();
+	}
+	return instance;
+}
+
+// Record a sample every intervalTicks; an interval of 0 disables sampling
+void Telemetry::start(int intervalTicks, size_t capacity) {
+	{
+		std::lock_guard<std::mutex> lock(samplesMutex);
+		samples.assign(std::max<size_t>(capacity, 1), Sample{});
+		nextSample = 0;
+		numRecorded = 0;
+	}
+
+	if (intervalTicks > 0) {
+		TimerWheel::getInstance()->schedulePeriodic(sampleTimer, intervalTicks, [this]() {
+			record();
+			});
+	}
+}
+
+void Telemetry::stop() {
+	TimerWheel::getInstance()->cancel(sampleTimer);
+}
+
+// Read the current state of the scheduler and the active allocator
+Telemetry::Sample Telemetry::sample() {
+	Scheduler* scheduler = Scheduler::getInstance();
+	ConsoleManager* config = ConsoleManager::getInstance();
+	Sample current{};
+
+	current.tick = TimerWheel::getInstance()->getCurrentTick();
+	current.activeTicks = scheduler->getBusyCpuTicks();
+	current.idleTicks = scheduler->getIdleCpuTicks();
+	current.coresBusy = scheduler->getCoresUsed();
+	current.numCores = scheduler->getNumCores();
+	current.queueLength = static_cast<uint32_t>(scheduler->getQueueLength());
+	current.waitingForIo = static_cast<uint32_t>(scheduler->getNumWaitingForIo());
+
+	if (config->getMinMemPerProc() == config->getMaxMemPerProc()) {
+		current.memoryUsed = FlatMemoryAllocator::getInstance()->getAllocatedSize();
+		current.framesFree = (config->getMaxOverallMem() - current.memoryUsed) / std::max<size_t>(config->getMemPerFrame(), 1);
+	}
+	else {
+		current.framesFree = PagingAllocator::getInstance()->getNumFreeFrames();
+		current.memoryUsed = PagingAllocator::getInstance()->calculateUsedFrames() * config->getMemPerFrame();
+	}
+	current.pagedIn = PagingAllocator::getInstance()->getNumPagedIn();
+	current.pagedOut = PagingAllocator::getInstance()->getNumPagedOut();
+	return current;
+}
+
+// Take a sample into the ring buffer, overwriting the oldest once it is full
+void Telemetry::record() {
+	Sample current = sample();
+
+	std::lock_guard<std::mutex> lock(samplesMutex);
+	if (samples.empty()) {
+		return;
+	}
+	samples[nextSample] = current;
+	nextSample = (nextSample + 1) % samples.size();
+	numRecorded++;
+}
+
+std::vector<Telemetry::Sample> Telemetry::getSamples() {
+	std::lock_guard<std::mutex> lock(samplesMutex);
+	std::vector<Sample> ordered;
+
+	if (numRecorded < samples.size()) {
+		ordered.assign(samples.begin(), samples.begin() + numRecorded);
+	}
+	else {
+		ordered.assign(samples.begin() + nextSample, samples.end());
+		ordered.insert(ordered.end(), samples.begin(), samples.begin() + nextSample);
+	}
+	return ordered;
+}
+
+uint64_t Telemetry::getNumRecorded() {
+	std::lock_guard<std::mutex> lock(samplesMutex);
+	return numRecorded;
+}
+
+// Percent of core ticks spent executing between two samples; busy cores now when no ticks passed
+double Telemetry::getCpuUtilization(const Sample& previous, const Sample& current) {
+	uint64_t active = current.activeTicks - previous.activeTicks;
+	uint64_t total = active + current.idleTicks - previous.idleTicks;
+
+	if (total == 0) {
+		return current.numCores > 0 ? 100.0 * current.coresBusy / current.numCores : 0.0;
+	}
+	return 100.0 * active / total;
+}
+
+bool Telemetry::exportCsv(const std::string& fileName) {
+	std::ofstream file(fileName, std::ios::out | std::ios::trunc);
+	if (!file) {
+		return false;
+	}
+
+	file << "tick,cpu_utilization,cores_busy,num_cores,queue_length,waiting_for_io,memory_used_kb,frames_free,paged_in,paged_out\n";
+
+	std::vector<Sample> ordered = getSamples();
+	for (size_t i = 0; i < ordered.size(); i++) {
+		const Sample& current = ordered[i];
+		double utilization = getCpuUtilization(i > 0 ? ordered[i - 1] : current, current);
+
+		file << current.tick << "," << utilization << "," << current.coresBusy << "," << current.numCores << ","
+			<< current.queueLength << "," << current.waitingForIo << "," << current.memoryUsed << ","
+			<< current.framesFree << "," << current.pagedIn << "," << current.pagedOut << "\n";
+	}
+	return static_cast<bool>(file);
+}
+
+bool Telemetry::exportBinary(const std::string& fileName) {
+	std::ofstream file(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file) {
+		return false;
+	}
+
+	std::vector<Sample> ordered = getSamples();
+	uint32_t sampleSize = sizeof(Sample);
+	uint32_t numSamples = static_cast<uint32_t>(ordered.size());
+
+	file.write(TELEMETRY_MAGIC, sizeof(TELEMETRY_MAGIC));
+	file.write(reinterpret_cast<const char*>(&TELEMETRY_VERSION), sizeof(TELEMETRY_VERSION));
+	file.write(reinterpret_cast<const char*>(&sampleSize), sizeof(sampleSize));
+	file.write(reinterpret_cast<const char*>(&numSamples), sizeof(numSamples));
+	file.write(reinterpret_cast<const char*>(ordered.data()), ordered.size() * sizeof(Sample));
+	return static_cast<bool>(file);
+}
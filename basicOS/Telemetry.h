@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+
+#include "TimerWheel.h"
+
+// Time series of system state. Every interval ticks a sample is taken on the sim clock
+// and stored in a fixed-size ring buffer, so a run keeps its most recent history
+// without growing.
+class Telemetry
+{
+public:
+	struct Sample
+	{
+		uint64_t tick;
+		uint64_t activeTicks;	// Cumulative, the per-interval utilization is the difference of two samples
+		uint64_t idleTicks;
+		uint64_t memoryUsed;	// KB
+		uint64_t framesFree;
+		uint64_t pagedIn;
+		uint64_t pagedOut;
+		uint32_t coresBusy;
+		uint32_t numCores;
+		uint32_t queueLength;
+		uint32_t waitingForIo;
+	};
+
+	static Telemetry* getInstance();
+
+	void start(int intervalTicks, size_t capacity);
+	void stop();
+
+	Sample sample();
+	void record();
+	std::vector<Sample> getSamples();	// Oldest first
+	uint64_t getNumRecorded();
+	static double getCpuUtilization(const Sample& previous, const Sample& current);
+
+	bool exportCsv(const std::string& fileName);
+	bool exportBinary(const std::string& fileName);
+
+private:
+	static Telemetry* telemetry;
+	TimerWheel::Timer sampleTimer;
+	std::vector<Sample> samples;
+	size_t nextSample = 0;
+	uint64_t numRecorded = 0;
+	std::mutex samplesMutex;
+};
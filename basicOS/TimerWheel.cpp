@@ -0,0 +1,255 @@
+#include <chrono>
+#include <algorithm>
+
+#include "TimerWheel.h"
+#include "Machine.h"
+
+using namespace std;
+
+TimerWheel* TimerWheel::timerWheel = nullptr;
+
+TimerWheel::TimerWheel()
+{
+	// Every slot is an empty circular list
+	for (int level = 0; level < LEVELS; level++) {
+		for (int slot = 0; slot < SLOTS; slot++) {
+			slots[level][slot].prev = &slots[level][slot];
+			slots[level][slot].next = &slots[level][slot];
+		}
+	}
+}
+
+TimerWheel::~TimerWheel()
+{
+	stop();
+}
+
+TimerWheel* TimerWheel::getInstance() {
+	TimerWheel*& instance = Machine::slot(&Machine::timerWheel, timerWheel);
+	if (instance == nullptr) {
+		instance = new TimerWheel();
+	}
+	return instance;
+}
+
+// Advance the clock by one tick every tickDurationMs; 0 runs the simulation as fast as possible.
+// beforeTick, if given, runs on the clock thread ahead of every tick.
+void TimerWheel::start(int tickDurationMs, std::function<void()> beforeTick) {
+	if (running.exchange(true)) {
+		return;
+	}
+
+	Machine* machine = Machine::current();
+	clockThread = std::thread([this, tickDurationMs, beforeTick, machine]() {
+		if (machine != nullptr) {
+			machine->enter();
+		}
+		while (running) {
+			if (tickDurationMs > 0) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(tickDurationMs));
+			}
+			else {
+				std::this_thread::yield();
+			}
+			if (beforeTick) {
+				beforeTick();
+			}
+			advance();
+		}
+		});
+}
+
+void TimerWheel::stop() {
+	{
+		std::lock_guard<std::mutex> lock(clockMutex);
+		running = false;
+	}
+	clockCondition.notify_all();
+
+	if (clockThread.joinable() && clockThread.get_id() != std::this_thread::get_id()) {
+		clockThread.join();
+	}
+}
+
+// Move the clock forward, firing every timer that expires on the way.
+// Callbacks run without the wheel lock held, so they may schedule or cancel timers.
+void TimerWheel::advance(uint64_t ticks) {
+	for (uint64_t i = 0; i < ticks; i++) {
+		Link expired;
+		expired.prev = &expired;
+		expired.next = &expired;
+		uint64_t tick;
+
+		{
+			std::lock_guard<std::mutex> lock(wheelMutex);
+			tick = ++currentTick;
+
+			// A wrapped level hands its next slot down to the finer levels
+			for (int level = 1; level < LEVELS; level++) {
+				if ((tick & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) != 0) {
+					break;
+				}
+				cascade(level);
+			}
+
+			// Splice the due slot onto the local expired list
+			Link& slot = slots[0][tick & (SLOTS - 1)];
+			if (slot.next != &slot) {
+				expired.next = slot.next;
+				expired.prev = slot.prev;
+				expired.next->prev = &expired;
+				expired.prev->next = &expired;
+				slot.prev = &slot;
+				slot.next = &slot;
+			}
+		}
+
+		while (true) {
+			std::function<void()> callback;
+			{
+				std::lock_guard<std::mutex> lock(wheelMutex);
+				if (expired.next == &expired) {
+					break;
+				}
+
+				Timer* timer = static_cast<Timer*>(expired.next);
+				unlink(timer);
+
+				if (timer->period > 0) {
+					callback = timer->callback;
+					timer->expires = tick + timer->period;
+					add(timer);
+				}
+				else {
+					// One-shot callbacks are moved out so their captures are released after firing
+					callback = std::move(timer->callback);
+					timer->callback = nullptr;
+					numScheduled--;
+				}
+			}
+
+			numFired++;
+			if (callback) {
+				callback();
+			}
+		}
+
+		// Wake cores waiting on the clock only after this tick's timers have fired
+		{
+			std::lock_guard<std::mutex> lock(clockMutex);
+			completedTick = tick;
+		}
+		clockCondition.notify_all();
+	}
+}
+
+uint64_t TimerWheel::getCurrentTick() const {
+	return currentTick;
+}
+
+// Block the caller until the timers of the given sim tick have fired; returns false once the clock stops
+bool TimerWheel::waitUntil(uint64_t tick) {
+	std::unique_lock<std::mutex> lock(clockMutex);
+	clockCondition.wait(lock, [this, tick]() { return completedTick >= tick || !running; });
+	return running;
+}
+
+// Block the caller for the given number of sim ticks; returns false once the clock stops
+bool TimerWheel::waitTicks(uint64_t ticks) {
+	std::unique_lock<std::mutex> lock(clockMutex);
+	uint64_t target = completedTick + ticks;
+	clockCondition.wait(lock, [this, target]() { return completedTick >= target || !running; });
+	return running;
+}
+
+void TimerWheel::schedule(Timer& timer, uint64_t delayTicks, std::function<void()> callback) {
+	std::lock_guard<std::mutex> lock(wheelMutex);
+	if (timer.isScheduled()) {
+		unlink(&timer);
+	}
+	else {
+		numScheduled++;
+	}
+
+	timer.callback = std::move(callback);
+	timer.period = 0;
+	timer.expires = currentTick + std::max<uint64_t>(delayTicks, 1);
+	add(&timer);
+}
+
+void TimerWheel::schedulePeriodic(Timer& timer, uint64_t periodTicks, std::function<void()> callback) {
+	std::lock_guard<std::mutex> lock(wheelMutex);
+	if (timer.isScheduled()) {
+		unlink(&timer);
+	}
+	else {
+		numScheduled++;
+	}
+
+	timer.callback = std::move(callback);
+	timer.period = std::max<uint64_t>(periodTicks, 1);
+	timer.expires = currentTick + timer.period;
+	add(&timer);
+}
+
+// Returns false when the timer was not pending
+bool TimerWheel::cancel(Timer& timer) {
+	std::lock_guard<std::mutex> lock(wheelMutex);
+	if (!timer.isScheduled()) {
+		return false;
+	}
+
+	unlink(&timer);
+	timer.callback = nullptr;
+	numScheduled--;
+	return true;
+}
+
+size_t TimerWheel::getNumScheduled() const {
+	std::lock_guard<std::mutex> lock(wheelMutex);
+	return numScheduled;
+}
+
+size_t TimerWheel::getNumFired() const {
+	return numFired;
+}
+
+// Place the timer in the finest level whose span covers its remaining ticks
+void TimerWheel::add(Timer* timer) {
+	uint64_t expires = std::max<uint64_t>(timer->expires, currentTick);
+	uint64_t delta = expires - currentTick;
+
+	int level = 0;
+	while (level < LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+		level++;
+	}
+
+	// Timers beyond the wheel's range wait in the last slot of the top level and cascade again
+	if (delta >= (uint64_t(1) << (SLOT_BITS * LEVELS))) {
+		expires = currentTick + (uint64_t(1) << (SLOT_BITS * LEVELS)) - 1;
+	}
+
+	Link& slot = slots[level][(expires >> (SLOT_BITS * level)) & (SLOTS - 1)];
+	timer->prev = slot.prev;
+	timer->next = &slot;
+	slot.prev->next = timer;
+	slot.prev = timer;
+}
+
+void TimerWheel::unlink(Timer* timer) {
+	timer->prev->next = timer->next;
+	timer->next->prev = timer->prev;
+	timer->prev = nullptr;
+	timer->next = nullptr;
+}
+
+// Re-insert every timer of the level's current slot; they land in finer levels
+void TimerWheel::cascade(int level) {
+	Link& slot = slots[level][(currentTick >> (SLOT_BITS * level)) & (SLOTS - 1)];
+
+	while (slot.next != &slot) {
+		Timer* timer = static_cast<Timer*>(slot.next);
+		unlink(timer);
+		add(timer);
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+// Hierarchical timing wheel driven by the simulation clock.
+// Timers are intrusive nodes owned by the caller, so scheduling and cancelling are O(1)
+// and never allocate; a timer must stay alive until it fires or is cancelled.
+class TimerWheel
+{
+public:
+	struct Link
+	{
+		Link* prev = nullptr;
+		Link* next = nullptr;
+	};
+
+	struct Timer : Link
+	{
+		uint64_t expires = 0;
+		uint64_t period = 0;	// Re-armed every period ticks when non-zero
+		std::function<void()> callback;
+
+		bool isScheduled() const { return prev != nullptr; }
+	};
+
+	static const int LEVELS = 4;
+	static const int SLOT_BITS = 6;
+	static const int SLOTS = 1 << SLOT_BITS;
+
+	TimerWheel();
+	~TimerWheel();
+
+	static TimerWheel* getInstance();
+
+	// Sim clock
+	void start(int tickDurationMs, std::function<void()> beforeTick = nullptr);
+	void stop();
+	void advance(uint64_t ticks = 1);
+	uint64_t getCurrentTick() const;
+	bool waitTicks(uint64_t ticks);
+	bool waitUntil(uint64_t tick);
+
+	void schedule(Timer& timer, uint64_t delayTicks, std::function<void()> callback);
+	void schedulePeriodic(Timer& timer, uint64_t periodTicks, std::function<void()> callback);
+	bool cancel(Timer& timer);
+
+	size_t getNumScheduled() const;
+	size_t getNumFired() const;
+
+private:
+	static TimerWheel* timerWheel;
+
+	void add(Timer* timer);
+	void unlink(Timer* timer);
+	void cascade(int level);
+
+	Link slots[LEVELS][SLOTS];
+	std::atomic<uint64_t> currentTick = 0;
+	size_t numScheduled = 0;
+	std::atomic<size_t> numFired = 0;
+
+	mutable std::mutex wheelMutex;
+	std::mutex clockMutex;
+	uint64_t completedTick = 0;	// Last tick whose timers have all fired
+	std::condition_variable clockCondition;
+	std::atomic<bool> running = false;
+	std::thread clockThread;
+};
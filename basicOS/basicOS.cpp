@@ -20,13 +20,51 @@
 #include "Scheduler.h"
 #include "FlatMemoryAllocator.h"
 #include "PagingAllocator.h"
+#include "SwapPool.h"
+#include "Profiler.h"
+#include "Replay.h"
+#include "Sweep.h"
 
 using namespace std;
 
-int main()
+int main(int argc, char* argv[])
 {
     ConsoleManager::initialize();
+
+    // Headless: basicOS --replay <trace> [--report <file>]
+    if (argc > 1 && string(argv[1]) == "--replay") {
+        if (argc != 3 && !(argc == 5 && string(argv[3]) == "--report")) {
+            cerr << "usage: basicOS --replay <trace> [--report <file>]" << endl;
+            return 1;
+        }
+        return Replay::run(argv[2], argc == 5 ? argv[4] : "");
+    }
+
+    // Headless: basicOS --sweep <grid> <trace> [--jobs <n>] [--report <file>]
+    if (argc > 1 && string(argv[1]) == "--sweep") {
+        int numJobs = 0;
+        string reportFile;
+        bool valid = argc >= 4 && argc % 2 == 0;
+        for (int i = 4; valid && i + 1 < argc; i += 2) {
+            if (string(argv[i]) == "--jobs" && isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                numJobs = atoi(argv[i + 1]);
+            }
+            else if (string(argv[i]) == "--report") {
+                reportFile = argv[i + 1];
+            }
+            else {
+                valid = false;
+            }
+        }
+        if (!valid) {
+            cerr << "usage: basicOS --sweep <grid> <trace> [--jobs <n>] [--report <file>]" << endl;
+            return 1;
+        }
+        return Sweep::run(argv[2], argv[3], numJobs, reportFile);
+    }
+
     InputHandler::initialize();
+    PROFILE_THREAD("console");
 
     shared_ptr<ProcessScreen> mainScreen = make_shared<ConsoleScreen>(MAIN_CONSOLE);
 
@@ -39,6 +77,7 @@ int main()
 
     FlatMemoryAllocator::initialize(maxOverallMem);
     PagingAllocator::initialize(maxOverallMem);
+    SwapPool::initialize(ConsoleManager::getInstance()->getSwapPoolSize(), ConsoleManager::getInstance()->getSwapDirectory());
 
     while (running){
         InputHandler::getInstance()->handleMainConsoleInput();
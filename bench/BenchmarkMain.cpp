@@ -0,0 +1,422 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <ctime>
+
+#include "ConsoleManager.h"
+#include "FlatMemoryAllocator.h"
+#include "PagingAllocator.h"
+#include "SwapPool.h"
+#include "Scheduler.h"
+#include "TimerWheel.h"
+#include "ObjectPool.h"
+#include "Process.h"
+#include "Machine.h"
+#include "HeapCounter.h"
+
+using namespace std;
+
+// Standalone benchmarks for the memory allocators and the scheduler's ready queue.
+// They call the emulator's classes directly, without the console or the clock thread,
+// and print one line per result (JSON, or CSV with --csv) so runs can be compared over time.
+// Every benchmark runs on its own machine, so its processes and allocators go away with it.
+// Heap allocations are counted by the replacement operator new in HeapCounter.cpp.
+
+struct Options
+{
+	int repeat = 5;
+	bool quick = false;
+	bool csv = false;
+	string filter;
+};
+
+struct Measurement
+{
+	size_t ops = 0;
+	double seconds = 0;
+	size_t heapAllocations = 0;
+};
+
+static Options options;
+
+// Configure the emulator and create fresh allocators. minMem == maxMem selects flat memory.
+static void configure(size_t maxOverallMem, size_t memPerFrame, size_t minMemPerProc, size_t maxMemPerProc, int minIns, int maxIns) {
+	ConsoleManager* console = ConsoleManager::getInstance();
+	console->setSchedulerConfig("rr");
+	console->setTimeSlice(5);
+	console->setDelayPerExec(0);
+	console->setMinIns(minIns);
+	console->setMaxIns(maxIns);
+	console->setMaxOverallMem(maxOverallMem);
+	console->setMemPerFrame(memPerFrame);
+	console->setMinMemPerProc(minMemPerProc);
+	console->setMaxMemPerProc(maxMemPerProc);
+	console->setIoFrequency(0);
+	console->setNumPages();
+	console->initializeAllocators();
+}
+
+static vector<shared_ptr<Process>> createProcesses(size_t count) {
+	static size_t processCounter = 0;
+	vector<shared_ptr<Process>> processes;
+	processes.reserve(count);
+
+	for (size_t i = 0; i < count; i++) {
+		processes.push_back(makePooled<Process>("bench_" + to_string(processCounter++), 0, time(nullptr), ConsoleManager::getInstance()->getMinMemPerProc()));
+	}
+	return processes;
+}
+
+static void printHeader() {
+	if (options.csv) {
+		cout << "benchmark,cores,ops,seconds,ns_per_op,ops_per_sec,heap_allocs_per_op" << endl;
+	}
+}
+
+static void printResult(const string& name, int cores, const Measurement& result) {
+	double nsPerOp = result.ops > 0 ? result.seconds * 1e9 / result.ops : 0;
+	double opsPerSec = result.seconds > 0 ? result.ops / result.seconds : 0;
+	double allocsPerOp = result.ops > 0 ? static_cast<double>(result.heapAllocations) / result.ops : 0;
+
+	cout << fixed << setprecision(3);
+	if (options.csv) {
+		cout << name << "," << cores << "," << result.ops << "," << setprecision(6) << result.seconds << "," << setprecision(3) << nsPerOp << "," << opsPerSec << "," << allocsPerOp << endl;
+	}
+	else {
+		cout << "{\"benchmark\":\"" << name << "\",\"cores\":" << cores << ",\"ops\":" << result.ops
+			<< ",\"seconds\":" << setprecision(6) << result.seconds << setprecision(3) << ",\"ns_per_op\":" << nsPerOp
+			<< ",\"ops_per_sec\":" << opsPerSec << ",\"heap_allocs_per_op\":" << allocsPerOp << ",\"repeat\":" << options.repeat << "}" << endl;
+	}
+	cout << defaultfloat;
+}
+
+static bool isSelected(const string& name) {
+	return options.filter.empty() || name.find(options.filter) != string::npos;
+}
+
+static Measurement median(vector<Measurement> runs) {
+	sort(runs.begin(), runs.end(), [](const Measurement& a, const Measurement& b) {
+		return a.seconds / max<size_t>(a.ops, 1) < b.seconds / max<size_t>(b.ops, 1);
+		});
+	return runs[runs.size() / 2];
+}
+
+// Run a benchmark options.repeat times and report the median; each run does its own untimed setup
+static void run(const string& name, int cores, const function<Measurement()>& benchmark) {
+	if (!isSelected(name)) {
+		return;
+	}
+
+	vector<Measurement> runs;
+	for (int i = 0; i < options.repeat; i++) {
+		runs.push_back(benchmark());
+	}
+	printResult(name, cores, median(runs));
+}
+
+template <typename Body>
+static Measurement timed(size_t ops, Body body) {
+	size_t allocationsBefore = HeapCounter::getAllocations();
+	auto start = chrono::steady_clock::now();
+	body();
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	return { ops, seconds, HeapCounter::getAllocations() - allocationsBefore };
+}
+
+// Memory allocators. Both run the same patterns against a pool of processes:
+//   churn      half full; free a random resident process and allocate another
+//   fragmented 90% full, so the holes left by random frees are scattered and scarce
+//   full       no free memory; every allocation fails (what dispatch sees while memory is full)
+//   fork       allocate a burst of processes into empty memory, then free them all
+class AllocatorBench
+{
+public:
+	virtual ~AllocatorBench() = default;
+	virtual void reset() = 0;
+	virtual bool allocate(size_t slot) = 0;
+	virtual void deallocate(size_t slot) = 0;
+
+	size_t numSlots = 0;
+	vector<shared_ptr<Process>> processes;
+};
+
+class FlatBench : public AllocatorBench
+{
+public:
+	FlatBench(size_t memory, size_t memPerProc) : memory(memory), memPerProc(memPerProc) {
+		configure(memory, memPerProc, memPerProc, memPerProc, 1, 1);
+		numSlots = memory / memPerProc;
+		processes = createProcesses(numSlots * 2);
+		memoryPtrs.resize(processes.size(), nullptr);
+	}
+
+	// A fresh allocator each run; the previous one is deleted, not leaked
+	void reset() override {
+		delete FlatMemoryAllocator::getInstance();
+		FlatMemoryAllocator::initialize(memory);
+		fill(memoryPtrs.begin(), memoryPtrs.end(), nullptr);
+	}
+
+	bool allocate(size_t slot) override {
+		memoryPtrs[slot] = FlatMemoryAllocator::getInstance()->allocate(memPerProc, processes[slot]->getPid(), processes[slot]);
+		return memoryPtrs[slot] != nullptr;
+	}
+
+	void deallocate(size_t slot) override {
+		FlatMemoryAllocator::getInstance()->deallocate(memoryPtrs[slot], processes[slot]);
+		memoryPtrs[slot] = nullptr;
+	}
+
+private:
+	size_t memory;
+	size_t memPerProc;
+	vector<void*> memoryPtrs;
+};
+
+class PagingBench : public AllocatorBench
+{
+public:
+	PagingBench(size_t memory, size_t memPerFrame, size_t memPerProc) : memory(memory) {
+		// min != max selects paging; both round down to the same number of pages
+		configure(memory, memPerFrame, memPerProc, memPerProc + 1, 1, 1);
+		numSlots = memory / memPerFrame / ConsoleManager::getInstance()->getNumPages();
+		processes = createProcesses(numSlots * 2);
+	}
+
+	void reset() override {
+		delete PagingAllocator::getInstance();
+		PagingAllocator::initialize(memory);
+	}
+
+	bool allocate(size_t slot) override {
+		return PagingAllocator::getInstance()->allocate(processes[slot]);
+	}
+
+	void deallocate(size_t slot) override {
+		PagingAllocator::getInstance()->deallocate(processes[slot]);
+	}
+
+private:
+	size_t memory;
+};
+
+// Keep `resident` of the slots allocated and replace a random one on every op
+static Measurement replaceRandom(AllocatorBench& bench, size_t resident, size_t ops) {
+	bench.reset();
+	mt19937 gen(42);
+	vector<size_t> inMemory;
+	vector<size_t> outOfMemory;
+
+	for (size_t slot = 0; slot < bench.processes.size(); slot++) {
+		if (inMemory.size() < resident && bench.allocate(slot)) {
+			inMemory.push_back(slot);
+		}
+		else {
+			outOfMemory.push_back(slot);
+		}
+	}
+
+	return timed(ops, [&]() {
+		for (size_t i = 0; i < ops; i++) {
+			size_t victim = gen() % inMemory.size();
+			size_t next = gen() % outOfMemory.size();
+
+			bench.deallocate(inMemory[victim]);
+			bench.allocate(outOfMemory[next]);
+			swap(inMemory[victim], outOfMemory[next]);
+		}
+		});
+}
+
+static Measurement allocateWhileFull(AllocatorBench& bench, size_t ops) {
+	bench.reset();
+	size_t slot = 0;
+	while (slot < bench.processes.size() && bench.allocate(slot)) {
+		slot++;
+	}
+
+	size_t failing = min(slot, bench.processes.size() - 1);
+	return timed(ops, [&]() {
+		for (size_t i = 0; i < ops; i++) {
+			bench.allocate(failing);
+		}
+		});
+}
+
+static Measurement forkBurst(AllocatorBench& bench, size_t rounds) {
+	bench.reset();
+	return timed(rounds * bench.numSlots, [&]() {
+		for (size_t round = 0; round < rounds; round++) {
+			for (size_t slot = 0; slot < bench.numSlots; slot++) {
+				bench.allocate(slot);
+			}
+			for (size_t slot = 0; slot < bench.numSlots; slot++) {
+				bench.deallocate(slot);
+			}
+		}
+		});
+}
+
+static void runAllocatorBenchmarks(const string& prefix, AllocatorBench& bench) {
+	size_t ops = options.quick ? 2000 : 50000;
+	size_t rounds = options.quick ? 5 : 100;
+
+	run(prefix + "/churn", 0, [&]() { return replaceRandom(bench, bench.numSlots / 2, ops); });
+	run(prefix + "/fragmented", 0, [&]() { return replaceRandom(bench, bench.numSlots * 9 / 10, ops); });
+	run(prefix + "/full", 0, [&]() { return allocateWhileFull(bench, ops); });
+	run(prefix + "/fork", 0, [&]() { return forkBurst(bench, rounds); });
+}
+
+// Scheduler: a batch of round-robin processes run to completion on n cores. Every core runs
+// one tick in turn and the sim clock advances after each pass, as the executors do in lockstep.
+// Reports the whole run's time per dispatch through the ready queue and per instruction executed.
+static void runSchedulerBenchmarks() {
+	int numIns = options.quick ? 20 : 100;
+	size_t processesPerCore = options.quick ? 8 : 32;
+
+	if (!isSelected("scheduler/run-per-dispatch") && !isSelected("scheduler/instructions")) {
+		return;
+	}
+
+	for (int cores = 1; cores <= 128; cores *= 2) {
+		vector<Measurement> dispatches;
+		vector<Measurement> instructions;
+
+		for (int i = 0; i < options.repeat; i++) {
+			// Deleted at the end of the run, scheduler, allocators and processes included
+			Machine machine;
+			machine.enter();
+			ConsoleManager::initialize(false);
+
+			// Enough frames that every process stays resident once dispatched
+			size_t numProcesses = processesPerCore * cores;
+			configure(numProcesses * 4 * 64, 64, 256, 257, numIns, numIns);
+			Scheduler::initialize(cores);
+			Scheduler* scheduler = Scheduler::getInstance();
+
+			vector<shared_ptr<Process>> processes = createProcesses(numProcesses);
+			for (const auto& process : processes) {
+				scheduler->addProcessToQueue(process);
+			}
+
+			size_t finished = 0;
+			Measurement result = timed(0, [&]() {
+				while (finished < processes.size()) {
+					for (int core = 0; core < cores; core++) {
+						scheduler->runTick(core);
+					}
+					TimerWheel::getInstance()->advance();
+
+					// Processes finish roughly in queue order
+					while (finished < processes.size() && processes[finished]->isFinished()) {
+						finished++;
+					}
+				}
+				});
+
+			dispatches.push_back({ scheduler->getNumDispatches(), result.seconds, result.heapAllocations });
+			instructions.push_back({ static_cast<size_t>(scheduler->getCpuCycles()), result.seconds, result.heapAllocations });
+		}
+
+		if (isSelected("scheduler/run-per-dispatch")) {
+			printResult("scheduler/run-per-dispatch", cores, median(dispatches));
+		}
+		if (isSelected("scheduler/instructions")) {
+			printResult("scheduler/instructions", cores, median(instructions));
+		}
+	}
+}
+
+// Process creation: batches of processes created and released through make_shared vs the
+// object pool. heap_allocs_per_op counts every operator new, pool chunks included.
+static void runProcessBenchmarks() {
+	size_t batchSize = 1000;
+	size_t numBatches = options.quick ? 5 : 50;
+
+	Machine machine;
+	machine.enter();
+	ConsoleManager::initialize(false);
+
+	vector<string> names;
+	for (size_t i = 0; i < batchSize; i++) {
+		names.push_back("bench_" + to_string(i));
+	}
+
+	auto runBatches = [&](auto create) {
+		vector<shared_ptr<Process>> batch;
+		batch.reserve(batchSize);
+
+		return timed(batchSize * numBatches, [&]() {
+			for (size_t b = 0; b < numBatches; b++) {
+				for (size_t i = 0; i < batchSize; i++) {
+					batch.push_back(create(names[i]));
+				}
+				batch.clear();
+			}
+			});
+	};
+
+	run("process/make_shared", 0, [&]() {
+		return runBatches([](const string& name) { return make_shared<Process>(name, 0, time(nullptr), 0); });
+		});
+	run("process/pool", 0, [&]() {
+		return runBatches([](const string& name) { return makePooled<Process>(name, 0, time(nullptr), 0); });
+		});
+}
+
+static void printUsage() {
+	cout << "usage: basicOS-bench [--quick] [--csv] [--repeat <n>] [--filter <text>]" << endl;
+	cout << "  --quick          smaller runs, for a smoke test" << endl;
+	cout << "  --csv            CSV instead of one JSON object per line" << endl;
+	cout << "  --repeat <n>     runs per benchmark; the median is reported (default 5)" << endl;
+	cout << "  --filter <text>  only benchmarks whose name contains text" << endl;
+}
+
+int main(int argc, char* argv[]) {
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "--quick") {
+			options.quick = true;
+		}
+		else if (arg == "--csv") {
+			options.csv = true;
+		}
+		else if (arg == "--repeat" && i + 1 < argc) {
+			options.repeat = max(1, atoi(argv[++i]));
+		}
+		else if (arg == "--filter" && i + 1 < argc) {
+			options.filter = argv[++i];
+		}
+		else {
+			printUsage();
+			return arg == "--help" ? 0 : 1;
+		}
+	}
+
+	printHeader();
+
+	// Defaults only; config.txt in the working directory is not read
+	{
+		Machine machine;
+		machine.enter();
+		ConsoleManager::initialize(false);
+		FlatBench flat(options.quick ? 16384 : 65536, 256);
+		runAllocatorBenchmarks("flat", flat);
+	}
+	{
+		Machine machine;
+		machine.enter();
+		ConsoleManager::initialize(false);
+		PagingBench paging(options.quick ? 16384 : 65536, 64, 256);
+		runAllocatorBenchmarks("paging", paging);
+	}
+	runProcessBenchmarks();
+	runSchedulerBenchmarks();
+	return 0;
+}
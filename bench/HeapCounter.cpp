@@ -0,0 +1,27 @@
+#include <cstdlib>
+#include <new>
+
+#include "HeapCounter.h"
+
+// Per thread, so counting costs no synchronisation and other threads do not skew a measurement
+static thread_local size_t heapAllocations = 0;
+
+void* operator new(size_t size) {
+	heapAllocations++;
+	if (void* block = std::malloc(size == 0 ? 1 : size)) {
+		return block;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* block) noexcept {
+	std::free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+	std::free(block);
+}
+
+size_t HeapCounter::getAllocations() {
+	return heapAllocations;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+
+// Counts heap allocations through a replacement global operator new, so benchmarks can
+// report real allocation counts rather than estimates. Only basicOS-bench links it; the
+// console keeps the standard allocator.
+class HeapCounter
+{
+public:
+	// Allocations made so far by the calling thread
+	static size_t getAllocations();
+};